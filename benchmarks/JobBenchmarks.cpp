@@ -0,0 +1,280 @@
+module;
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+export module YT:JobBenchmarks;
+
+import :Types;
+import :Wait;
+import :Coroutine;
+import :CoroEvent;
+import :JobManager;
+import :BackgroundTaskManager;
+
+namespace YT
+{
+    using BenchClock = std::chrono::steady_clock;
+
+    /// Swaps in a JobManager with the requested number of threads for the duration of one benchmark
+    class ScopedJobManager final
+    {
+    public:
+        explicit ScopedJobManager(int num_threads)
+        {
+            g_JobManager.reset();
+            g_JobManager = MakeUnique<JobManager>(num_threads);
+            g_JobManager->PrepareToRunJobs();
+        }
+
+        ScopedJobManager(const ScopedJobManager &) = delete;
+        ScopedJobManager & operator=(const ScopedJobManager &) = delete;
+
+        ~ScopedJobManager()
+        {
+            g_JobManager->StopRunningJobs();
+            g_JobManager.reset();
+        }
+    };
+
+    JobCoro<void> EmptyJob()
+    {
+        co_return;
+    }
+
+    JobCoro<int> LeafJob(int value)
+    {
+        co_return value;
+    }
+
+    JobCoro<int> FanOutJob(int num_children)
+    {
+        CoroBundle<int> children;
+        children.Reserve(static_cast<std::size_t>(num_children));
+
+        for (int i = 0; i < num_children; ++i)
+        {
+            children.PushJob(LeafJob(i));
+        }
+
+        co_await children;
+
+        int sum = 0;
+        for (std::size_t i = 0; i < children.Size(); ++i)
+        {
+            sum += children[i];
+        }
+
+        co_return sum;
+    }
+
+    MainThreadTask<int> MainHop(int value)
+    {
+        co_return value + 1;
+    }
+
+    BackgroundTask<int> BackgroundHop(int value)
+    {
+        co_return co_await MainHop(value + 1);
+    }
+
+    JobCoro<int> JobHop(int value)
+    {
+        co_return co_await BackgroundHop(value + 1);
+    }
+
+    JobCoro<void> WaitForEvent(CoroEvent & event, std::atomic_bool & waiting, std::atomic<BenchClock::rep> & resumed_at)
+    {
+        waiting.store(true, std::memory_order_release);
+        co_await CoroEventWait(event);
+        resumed_at.store(BenchClock::now().time_since_epoch().count(), std::memory_order_release);
+    }
+
+    /// Jobs spawned and retired per second, arg 0 is the thread count and arg 1 the batch size
+    void BM_SpawnThroughput(benchmark::State & state)
+    {
+        const ScopedJobManager job_manager(static_cast<int>(state.range(0)));
+        const std::size_t batch_size = static_cast<std::size_t>(state.range(1));
+
+        for (auto _ : state)
+        {
+            CoroBundle<void> jobs;
+            jobs.Reserve(batch_size);
+
+            for (std::size_t i = 0; i < batch_size; ++i)
+            {
+                jobs.PushJob(EmptyJob());
+            }
+
+            jobs.WaitForCompletion();
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch_size));
+    }
+
+    /// Time for a single empty job to be picked up by a job thread and report back to the main thread
+    void BM_EmptyJobRoundTrip(benchmark::State & state)
+    {
+        const ScopedJobManager job_manager(static_cast<int>(state.range(0)));
+
+        for (auto _ : state)
+        {
+            CoroBundle<void> jobs;
+            jobs.PushJob(EmptyJob());
+            jobs.WaitForCompletion();
+        }
+    }
+
+    /// One job spawning arg 1 children through a CoroBundle and co_awaiting them all
+    void BM_FanOutFanIn(benchmark::State & state)
+    {
+        const ScopedJobManager job_manager(static_cast<int>(state.range(0)));
+        const int num_children = static_cast<int>(state.range(1));
+
+        for (auto _ : state)
+        {
+            CoroBundle<int> root;
+            root.PushJob(FanOutJob(num_children));
+            root.WaitForCompletion();
+            benchmark::DoNotOptimize(root[0]);
+        }
+
+        state.SetItemsProcessed(state.iterations() * num_children);
+    }
+
+    /// Job -> Background -> Main and back again, four context switches per iteration
+    void BM_CrossContextHops(benchmark::State & state)
+    {
+        const ScopedJobManager job_manager(static_cast<int>(state.range(0)));
+
+        for (auto _ : state)
+        {
+            CoroBundle<int> root;
+            root.PushJob(JobHop(0));
+            root.WaitForCompletion();
+            benchmark::DoNotOptimize(root[0]);
+        }
+    }
+
+    /// Time from CoroEvent::Trigger on the main thread until a job thread has picked up the waiting job again
+    void BM_CoroEventWakeLatency(benchmark::State & state)
+    {
+        const ScopedJobManager job_manager(static_cast<int>(state.range(0)));
+
+        for (auto _ : state)
+        {
+            CoroEvent event;
+            std::atomic_bool waiting = false;
+            std::atomic<BenchClock::rep> resumed_at = 0;
+
+            CoroBundle<void> waiter;
+            waiter.PushJob(WaitForEvent(event, waiting, resumed_at));
+
+            while (!waiting.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            // Give the waiter a moment to actually suspend, otherwise we'd be timing await_ready
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+            const BenchClock::time_point triggered_at = BenchClock::now();
+            event.Trigger();
+
+            // The resume lands on our own deque, helping here would just time us resuming it ourselves. Waiting
+            // without helping leaves it to a job thread, so this measures how fast one wakes and steals it.
+            while (resumed_at.load(std::memory_order_acquire) == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            waiter.WaitForCompletion();
+
+            const BenchClock::time_point resumed{ BenchClock::duration{ resumed_at.load(std::memory_order_acquire) } };
+            state.SetIterationTime(std::chrono::duration<double>(resumed - triggered_at).count());
+        }
+    }
+
+    /// Thread counts from 2 (main plus one worker) up to the machine's, the main thread only waits in these
+    void ThreadCountArgs(benchmark::internal::Benchmark * benchmark)
+    {
+        const int max_threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        for (int threads = 2; threads < max_threads; threads *= 2)
+        {
+            benchmark->Arg(threads);
+        }
+        benchmark->Arg(max_threads);
+    }
+
+    void ThreadCountAndSizeArgs(benchmark::internal::Benchmark * benchmark, std::int64_t min_size, std::int64_t max_size)
+    {
+        const int max_threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        for (std::int64_t size = min_size; size <= max_size; size *= 8)
+        {
+            for (int threads = 2; threads < max_threads; threads *= 2)
+            {
+                benchmark->Args({ threads, size });
+            }
+            benchmark->Args({ max_threads, size });
+        }
+    }
+
+    BENCHMARK(BM_SpawnThroughput)
+        ->ArgNames({ "threads", "batch" })
+        ->Apply([](benchmark::internal::Benchmark * b) { ThreadCountAndSizeArgs(b, 64, 4096); })
+        ->UseRealTime();
+
+    BENCHMARK(BM_EmptyJobRoundTrip)
+        ->ArgName("threads")
+        ->Apply(ThreadCountArgs)
+        ->UseRealTime();
+
+    BENCHMARK(BM_FanOutFanIn)
+        ->ArgNames({ "threads", "children" })
+        ->Apply([](benchmark::internal::Benchmark * b) { ThreadCountAndSizeArgs(b, 8, 512); })
+        ->UseRealTime();
+
+    BENCHMARK(BM_CrossContextHops)
+        ->ArgName("threads")
+        ->Apply(ThreadCountArgs)
+        ->UseRealTime();
+
+    BENCHMARK(BM_CoroEventWakeLatency)
+        ->ArgName("threads")
+        ->Apply(ThreadCountArgs)
+        ->UseManualTime();
+}
+
+int main(int argc, char ** argv)
+{
+    using namespace YT;
+
+    InitWait();
+    SetCurrentThreadContext(ThreadContextType::Main);
+    MakeThreadLocalCoroutineAllocator();
+
+    if (!BackgroundTaskManager::CreateBackgroundTaskManager())
+    {
+        return 1;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    g_JobManager.reset();
+    g_BackgroundTaskManager.reset();
+    return 0;
+}
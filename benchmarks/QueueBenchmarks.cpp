@@ -0,0 +1,132 @@
+module;
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+export module YT:QueueBenchmarks;
+
+import :MultiProducerMultiConsumer;
+import :MultiProducerSingleConsumer;
+import :SingleProducerMultiConsumer;
+import :SingleProducerSingleConsumer;
+
+namespace YT
+{
+    constexpr std::size_t QueueCapacity = 1024;
+    constexpr std::size_t MaxBatchSize = 128;
+
+    /// Pushes then pops arg 0 items one at a time, the baseline the bulk versions are compared against
+    template <template <typename, std::size_t> typename Queue>
+    void BM_QueueSingleRoundTrip(benchmark::State & state)
+    {
+        static Queue<std::uint64_t, QueueCapacity> queue;
+        const std::size_t batch_size = static_cast<std::size_t>(state.range(0));
+
+        std::uint64_t value = 0;
+        for (auto _ : state)
+        {
+            for (std::size_t i = 0; i < batch_size; ++i)
+            {
+                benchmark::DoNotOptimize(queue.TryEnqueue(std::uint64_t{ i }));
+            }
+
+            for (std::size_t i = 0; i < batch_size; ++i)
+            {
+                benchmark::DoNotOptimize(queue.TryDequeue(value));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch_size));
+    }
+
+    /// Same traffic as BM_QueueSingleRoundTrip, but one TryEnqueueBulk and one TryDequeueBulk per batch
+    template <template <typename, std::size_t> typename Queue>
+    void BM_QueueBulkRoundTrip(benchmark::State & state)
+    {
+        static Queue<std::uint64_t, QueueCapacity> queue;
+        const std::size_t batch_size = static_cast<std::size_t>(state.range(0));
+
+        std::array<std::uint64_t, MaxBatchSize> input = {};
+        std::array<std::uint64_t, MaxBatchSize> output = {};
+        for (std::size_t i = 0; i < MaxBatchSize; ++i)
+        {
+            input[i] = i;
+        }
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(queue.TryEnqueueBulk(std::span<std::uint64_t>(input.data(), batch_size)));
+            benchmark::DoNotOptimize(queue.TryDequeueBulk(output.data(), batch_size));
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch_size));
+    }
+
+    /// Every thread pushes and pops arg 0 items on one shared queue, so the CAS count per item shows under contention
+    void BM_MultiProducerMultiConsumerContendedSingle(benchmark::State & state)
+    {
+        static MultiProducerMultiConsumer<std::uint64_t, QueueCapacity> queue;
+        const std::size_t batch_size = static_cast<std::size_t>(state.range(0));
+
+        std::uint64_t value = 0;
+        for (auto _ : state)
+        {
+            for (std::size_t i = 0; i < batch_size; ++i)
+            {
+                benchmark::DoNotOptimize(queue.TryEnqueue(std::uint64_t{ i }));
+            }
+
+            for (std::size_t i = 0; i < batch_size; ++i)
+            {
+                benchmark::DoNotOptimize(queue.TryDequeue(value));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch_size));
+    }
+
+    void BM_MultiProducerMultiConsumerContendedBulk(benchmark::State & state)
+    {
+        static MultiProducerMultiConsumer<std::uint64_t, QueueCapacity> queue;
+        const std::size_t batch_size = static_cast<std::size_t>(state.range(0));
+
+        std::array<std::uint64_t, MaxBatchSize> input = {};
+        std::array<std::uint64_t, MaxBatchSize> output = {};
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(queue.TryEnqueueBulk(std::span<std::uint64_t>(input.data(), batch_size)));
+            benchmark::DoNotOptimize(queue.TryDequeueBulk(output.data(), batch_size));
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch_size));
+    }
+
+    void BatchSizeArgs(benchmark::internal::Benchmark * benchmark)
+    {
+        benchmark->ArgName("batch");
+        for (const std::int64_t batch_size : { 1, 8, 32, 128 })
+        {
+            benchmark->Arg(batch_size);
+        }
+    }
+
+    BENCHMARK_TEMPLATE(BM_QueueSingleRoundTrip, MultiProducerMultiConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueBulkRoundTrip, MultiProducerMultiConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueSingleRoundTrip, MultiProducerSingleConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueBulkRoundTrip, MultiProducerSingleConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueSingleRoundTrip, SingleProducerMultiConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueBulkRoundTrip, SingleProducerMultiConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueSingleRoundTrip, SingleProducerSingleConsumer)->Apply(BatchSizeArgs);
+    BENCHMARK_TEMPLATE(BM_QueueBulkRoundTrip, SingleProducerSingleConsumer)->Apply(BatchSizeArgs);
+
+    BENCHMARK(BM_MultiProducerMultiConsumerContendedSingle)->Apply(BatchSizeArgs)->ThreadRange(2, 8)->UseRealTime();
+    BENCHMARK(BM_MultiProducerMultiConsumerContendedBulk)->Apply(BatchSizeArgs)->ThreadRange(2, 8)->UseRealTime();
+}
+
+BENCHMARK_MAIN();
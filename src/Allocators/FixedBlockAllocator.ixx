@@ -579,6 +579,25 @@ namespace YT
             return m_ThreadAllocator.Allocate();
         }
 
+        /**
+         * @brief Allocates a block of memory and reports where it came from.
+         *
+         * @param out_local_hit Set to true if the thread-local cache served the block, false if it fell back to the
+         *                      global allocator.
+         * @return A pointer to the allocated block, or nullptr if allocation failed.
+         */
+        [[nodiscard]] void * Allocate(bool & out_local_hit) noexcept
+        {
+            if (void * local_val = m_LocalAllocator->Allocate())
+            {
+                out_local_hit = true;
+                return local_val;
+            }
+
+            out_local_hit = false;
+            return m_ThreadAllocator.Allocate();
+        }
+
         /**
          * @brief Frees a previously allocated block.
          * 
@@ -0,0 +1,164 @@
+module;
+
+//import_std
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+export module YT:InplaceFunction;
+
+namespace YT
+{
+    /**
+     * @brief Forward declaration of the InplaceFunction template class.
+     * @tparam Signature The function signature type (e.g., void(int, float))
+     * @tparam Capacity Bytes of inline storage for the callable
+     */
+    export template <typename Signature, std::size_t Capacity>
+    class InplaceFunction;
+
+    /**
+     * @brief Move-only type-erased callable that never allocates.
+     *
+     * The callable is stored in a fixed inline buffer, binding anything that does not fit (or is over-aligned)
+     * fails to compile rather than falling back to the heap. Meant for queue slots where the common payload is
+     * a captured pointer or two, so a resume can be scheduled without touching the allocator.
+     *
+     * @tparam ReturnType The return type of the function
+     * @tparam Args The argument types of the function
+     * @tparam Capacity Bytes of inline storage for the callable
+     */
+    export template <typename ReturnType, typename... Args, std::size_t Capacity>
+    class InplaceFunction<ReturnType(Args...), Capacity> final
+    {
+    public:
+        InplaceFunction() noexcept = default;
+
+        InplaceFunction(std::nullptr_t) noexcept
+        {
+        }
+
+        template <typename Callable>
+            requires (!std::is_same_v<std::remove_cvref_t<Callable>, InplaceFunction> &&
+                      std::is_invocable_r_v<ReturnType, std::decay_t<Callable> &, Args...>)
+        InplaceFunction(Callable && callable) noexcept(std::is_nothrow_constructible_v<std::decay_t<Callable>, Callable>)
+        {
+            using StoredType = std::decay_t<Callable>;
+
+            static_assert(sizeof(StoredType) <= Capacity, "Callable does not fit in the InplaceFunction buffer, increase Capacity");
+            static_assert(alignof(StoredType) <= StorageAlignment, "Callable is over-aligned for InplaceFunction");
+            static_assert(std::is_nothrow_move_constructible_v<StoredType>, "InplaceFunction requires a nothrow move constructible callable");
+
+            ::new (static_cast<void *>(m_Storage)) StoredType(std::forward<Callable>(callable));
+            m_Ops = &s_Ops<StoredType>;
+        }
+
+        InplaceFunction(const InplaceFunction &) = delete;
+
+        InplaceFunction(InplaceFunction && rhs) noexcept
+        {
+            MoveFrom(rhs);
+        }
+
+        InplaceFunction & operator=(const InplaceFunction &) = delete;
+
+        InplaceFunction & operator=(InplaceFunction && rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                Reset();
+                MoveFrom(rhs);
+            }
+
+            return *this;
+        }
+
+        InplaceFunction & operator=(std::nullptr_t) noexcept
+        {
+            Reset();
+            return *this;
+        }
+
+        ~InplaceFunction() noexcept
+        {
+            Reset();
+        }
+
+        /**
+         * @brief Calls the stored callable.
+         * @pre The function must not be empty
+         */
+        ReturnType operator()(Args... args)
+        {
+            return m_Ops->m_Invoke(m_Storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_Ops != nullptr;
+        }
+
+        /// Destroys the stored callable, leaving the function empty
+        void Reset() noexcept
+        {
+            if (m_Ops)
+            {
+                m_Ops->m_Destroy(m_Storage);
+                m_Ops = nullptr;
+            }
+        }
+
+        static consteval std::size_t GetCapacity() noexcept
+        {
+            return Capacity;
+        }
+
+    private:
+
+        /// Type-erased operations for one stored callable type, one static instance per type
+        struct Operations
+        {
+            ReturnType (*m_Invoke)(void * storage, Args &&... args);
+            void (*m_Move)(void * dest, void * src) noexcept;       ///< Move constructs into dest and destroys src
+            void (*m_Destroy)(void * storage) noexcept;
+        };
+
+        template <typename StoredType>
+        static constexpr Operations s_Ops
+        {
+            .m_Invoke = [](void * storage, Args &&... args) -> ReturnType
+            {
+                return std::invoke_r<ReturnType>(*static_cast<StoredType *>(storage), std::forward<Args>(args)...);
+            },
+            .m_Move = [](void * dest, void * src) noexcept
+            {
+                StoredType * const src_callable = static_cast<StoredType *>(src);
+                ::new (dest) StoredType(std::move(*src_callable));
+                src_callable->~StoredType();
+            },
+            .m_Destroy = [](void * storage) noexcept
+            {
+                static_cast<StoredType *>(storage)->~StoredType();
+            },
+        };
+
+        void MoveFrom(InplaceFunction & rhs) noexcept
+        {
+            if (rhs.m_Ops)
+            {
+                rhs.m_Ops->m_Move(m_Storage, rhs.m_Storage);
+                m_Ops = std::exchange(rhs.m_Ops, nullptr);
+            }
+        }
+
+    private:
+        /// Pointer alignment covers captured pointers and references without padding every slot out to 16 bytes
+        static constexpr std::size_t StorageAlignment = alignof(void *);
+
+        alignas(StorageAlignment) std::byte m_Storage[Capacity];
+        const Operations * m_Ops = nullptr;
+    };
+}
@@ -17,6 +17,7 @@ import :FontManager;
 import :OwnedBuffer;
 import :FontLoad;
 import :Coroutine;
+import :Cancellation;
 import :FileMapper;
 
 namespace YT
@@ -83,6 +84,13 @@ namespace YT
     Coro<FontReference, ThreadContextType::AnyThread> LoadFontFromFile(const StringView & file_name) noexcept
     {
         MappedFile file = co_await MapFileAsync(file_name);
+
+        // Unmap straight away rather than holding the file until the FreeType thread gets to it
+        if ((co_await CurrentCancellationToken()).IsCancellationRequested())
+        {
+            co_return FontReference{};
+        }
+
         FontReference ref = co_await CreateFontReferenceFromMappedFile(std::move(file));
         co_return std::move(ref);
     }
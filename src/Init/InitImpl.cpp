@@ -17,6 +17,9 @@ import :FileMapper;
 import :FontManager;
 import :DeferredFontLoad;
 import :DeferredImageLoad;
+import :JobTrace;
+import :DeterministicScheduler;
+import :FrameTiming;
 
 namespace YT
 {
@@ -27,6 +30,15 @@ namespace YT
         g_InitTime = std::chrono::high_resolution_clock::now();
 
         SetCurrentThreadContext(ThreadContextType::Main);
+        SetJobTraceThreadName("Main");
+
+        Threading::Configure(init_info);
+        SetMainThreadWorkBudget(std::chrono::microseconds(init_info.m_MainThreadWorkBudgetUs));
+
+        if (Threading::IsDeterministicScheduling())
+        {
+            g_DeterministicScheduler = MakeUnique<DeterministicScheduler>(Threading::GetDeterministicSeed());
+        }
 
         if (!JobManager::CreateJobManager())
         {
@@ -82,8 +94,24 @@ namespace YT
     {
         while (!g_WindowManager->ShouldExit() && g_WindowManager->HasOpenWindows())
         {
+            BeginMainThreadFrame();
+
             g_WindowManager->DispatchEvents();
+
+            if (g_DeterministicScheduler)
+            {
+                g_DeterministicScheduler->RunUntilIdle();
+            }
+            else
+            {
+                // Budgeted so a burst of continuations is spread over a few frames instead of hitching one
+                RunMainThreadWork();
+            }
+
             g_WindowManager->RenderWindows();
+
+            EndMainThreadFrame();
+
             g_WindowManager->WaitForNextFrame();
         }
     }
@@ -2,14 +2,18 @@
 module;
 
 #include <array>
+#include <cstddef>
 #include <atomic>
 #include <thread>
 #include <semaphore>
+#include <span>
 
 export module YT:BackgroundTaskManager;
 
 import :Types;
+import :JobTypes;
 import :MultiProducerMultiConsumer;
+import :SpillQueue;
 
 namespace YT
 {
@@ -17,22 +21,36 @@ namespace YT
     {
     public:
 
-        static constexpr std::size_t NumThreads = Threading::NumFileMapperThreads;
-
         static bool CreateBackgroundTaskManager() noexcept;
 
-        BackgroundTaskManager();
+        explicit BackgroundTaskManager(std::size_t num_threads);
         ~BackgroundTaskManager();
 
-        void PushWork(Function<void()> && work);
+        void PushWork(WorkFunction && work);
+
+        /**
+         * @brief Queues a batch of work, moving out of each element.
+         *
+         * Wakes the pool once for the whole batch rather than once per item, and never more threads than there
+         * are items.
+         *
+         * @param work The work to queue, left holding empty functions
+         */
+        void PushWork(Span<WorkFunction> work);
 
-        void SignalWork();
+        /// Records count new items and wakes up to that many threads to run them
+        void SignalWork(std::size_t count = 1);
 
         void SyncAll() const noexcept;
 
+        [[nodiscard]] SpillQueueStats GetSpillStats() const noexcept
+        {
+            return m_Queue.GetStats();
+        }
+
     private:
 
-        void ThreadMain();
+        void ThreadMain(std::size_t thread_index);
 
     private:
 
@@ -41,8 +59,8 @@ namespace YT
         std::atomic_int m_Requests = 0;
         std::atomic_int m_Responses = 0;
 
-        MultiProducerMultiConsumer<Function<void()>, 8192> m_Queue;
-        std::array<std::thread, NumThreads> m_Threads;
+        SpillQueue<WorkFunction, 8192> m_Queue;
+        Vector<std::thread> m_Threads;
         std::counting_semaphore<> m_Semaphore;
     };
 
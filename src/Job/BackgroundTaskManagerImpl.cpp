@@ -1,11 +1,13 @@
 
 module;
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <thread>
 #include <semaphore>
 #include <new>
+#include <utility>
 
 module YT:BackgroundTaskManagerImpl;
 
@@ -13,6 +15,9 @@ import :BackgroundTaskManager;
 import :Coroutine;
 import :WorkerThread;
 import :WorkerThreadQueue;
+import :JobTrace;
+import :ThreadTopology;
+import :Wait;
 
 namespace YT
 {
@@ -25,7 +30,7 @@ namespace YT
 
         try
         {
-            g_BackgroundTaskManager = MakeUnique<BackgroundTaskManager>();
+            g_BackgroundTaskManager = MakeUnique<BackgroundTaskManager>(Threading::GetNumBackgroundThreads());
             return true;
         }
         catch (...)
@@ -34,19 +39,20 @@ namespace YT
         }
     }
 
-    BackgroundTaskManager::BackgroundTaskManager()
+    BackgroundTaskManager::BackgroundTaskManager(std::size_t num_threads)
         : m_Running { true }, m_Semaphore { 0 }
     {
-        for (std::thread & thread : m_Threads)
+        m_Threads.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i)
         {
-            thread = std::thread([this]{ ThreadMain(); });
+            m_Threads.emplace_back([this, i]{ ThreadMain(i); });
         }
     }
 
     BackgroundTaskManager::~BackgroundTaskManager()
     {
         m_Running = false;
-        m_Semaphore.release(NumThreads);
+        m_Semaphore.release(static_cast<std::ptrdiff_t>(m_Threads.size()));
 
         for (std::thread & thread : m_Threads)
         {
@@ -54,51 +60,66 @@ namespace YT
         }
     }
 
-    void BackgroundTaskManager::PushWork(Function<void()> && work)
+    void BackgroundTaskManager::PushWork(WorkFunction && work)
+    {
+        m_Queue.Enqueue(std::move(work));
+        SignalWork();
+    }
+
+    void BackgroundTaskManager::PushWork(Span<WorkFunction> work)
     {
-        while (!m_Queue.TryEnqueue(std::move(work)))
+        m_Queue.EnqueueBulk(work);
+
+        if (!work.empty())
         {
-            std::this_thread::yield();
+            SignalWork(work.size());
         }
-
-        SignalWork();
     }
 
-    void BackgroundTaskManager::SignalWork()
+    void BackgroundTaskManager::SignalWork(std::size_t count)
     {
-        m_Requests.fetch_add(1, std::memory_order_release);
-        m_Semaphore.release();
+        m_Requests.fetch_add(static_cast<int>(count), std::memory_order_release);
+
+        // Every woken thread drains the queue, so more wakeups than threads would only cost spurious wakes later
+        const std::size_t num_wakeups = std::min(count, m_Threads.size());
+        m_Semaphore.release(static_cast<std::ptrdiff_t>(num_wakeups));
     }
 
     void BackgroundTaskManager::SyncAll() const noexcept
     {
         while (true)
         {
-            MonitorAddr(&m_Responses);
-            if (m_Requests.load() == m_Responses.load())
+            const int responses = m_Responses.load(std::memory_order_acquire);
+            if (m_Requests.load(std::memory_order_acquire) == responses)
             {
                 break;
             }
 
-            WaitForAddr(150000);
+            AtomicWait(m_Responses, responses);
         }
     }
 
 
-    void BackgroundTaskManager::ThreadMain()
+    void BackgroundTaskManager::ThreadMain(std::size_t thread_index)
     {
         MakeThreadLocalCoroutineAllocator();
         SetCurrentThreadContext(ThreadContextType::Background);
+        SetJobTraceThreadName("Background", static_cast<int>(thread_index));
+        ApplyThreadAffinity(ThreadPoolType::Background, thread_index);
 
         while (m_Running.load(std::memory_order_relaxed))
         {
             m_Semaphore.acquire();
 
-            Function<void()> work;
+            WorkFunction work;
             while (m_Queue.TryDequeue(work))
             {
-                work();
-                m_Responses.fetch_add(1, std::memory_order_acquire);
+                {
+                    const JobTraceWorkScope trace_scope(&work, ThreadContextType::Background);
+                    work();
+                }
+                m_Responses.fetch_add(1, std::memory_order_release);
+                AtomicNotify(m_Responses);
             }
 
             auto ProcessWorkQueue = [&](WorkerThreadQueue & queue) -> void
@@ -106,7 +127,11 @@ namespace YT
                 SetCurrentThreadContext(queue.GetThreadContextType());
                 int work_completed = queue.TryExecuteWork();
 
-                m_Responses.fetch_add(work_completed, std::memory_order_release);
+                if (work_completed > 0)
+                {
+                    m_Responses.fetch_add(work_completed, std::memory_order_release);
+                    AtomicNotify(m_Responses);
+                }
             };
 
             ProcessWorkQueue(g_FreeTypeThreadQueue);
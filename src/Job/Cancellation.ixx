@@ -0,0 +1,171 @@
+module;
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+export module YT:Cancellation;
+
+namespace YT
+{
+    /// Shared between a CancellationSource and its tokens, freed with the last of them
+    class CancellationState final
+    {
+    public:
+        void AddRef() noexcept
+        {
+            m_RefCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void Release() noexcept
+        {
+            if (m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+
+        void Cancel() noexcept
+        {
+            m_Cancelled.store(true, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool IsCancelled() const noexcept
+        {
+            return m_Cancelled.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::atomic_uint32_t m_RefCount = 1;
+        std::atomic_bool m_Cancelled = false;
+    };
+
+    /**
+     * @brief Read side of a CancellationSource.
+     *
+     * Attach one to a coroutine with WithCancellation, coroutines it awaits inherit it. Once cancelled, awaiting
+     * a child coroutine that returns void or a default constructible type skips the child and yields a default
+     * result, so the chain unwinds at its next co_await. That is the only await that checks the token:
+     * - A child whose result can't be default constructed still runs, there is nothing to hand back instead
+     * - WhenAll and WhenAny pass the token on to their children but always start them
+     * - CoroBundle, CoroEventWait, Delay, MapFileAsync and the channel, mutex and semaphore awaits ignore it
+     *
+     * Code that should stop early around those polls co_await CurrentCancellationToken(). A default constructed
+     * token is never cancelled.
+     */
+    export class CancellationToken final
+    {
+    public:
+        CancellationToken() noexcept = default;
+
+        CancellationToken(const CancellationToken & rhs) noexcept
+            : m_State(rhs.m_State)
+        {
+            if (m_State)
+            {
+                m_State->AddRef();
+            }
+        }
+
+        CancellationToken(CancellationToken && rhs) noexcept
+            : m_State(std::exchange(rhs.m_State, nullptr))
+        {}
+
+        CancellationToken & operator=(const CancellationToken & rhs) noexcept
+        {
+            CancellationToken copy(rhs);
+            std::swap(m_State, copy.m_State);
+            return *this;
+        }
+
+        CancellationToken & operator=(CancellationToken && rhs) noexcept
+        {
+            CancellationToken moved(std::move(rhs));
+            std::swap(m_State, moved.m_State);
+            return *this;
+        }
+
+        ~CancellationToken() noexcept
+        {
+            if (m_State)
+            {
+                m_State->Release();
+            }
+        }
+
+        [[nodiscard]] bool IsCancellationRequested() const noexcept
+        {
+            return m_State && m_State->IsCancelled();
+        }
+
+        /// False for a default constructed token that can never be cancelled
+        explicit operator bool() const noexcept
+        {
+            return m_State != nullptr;
+        }
+
+    private:
+        friend class CancellationSource;
+
+        explicit CancellationToken(CancellationState * state) noexcept
+            : m_State(state)
+        {
+            m_State->AddRef();
+        }
+
+    private:
+        CancellationState * m_State = nullptr;
+    };
+
+    /// Owned by whoever may want to abandon the work, e.g. the widget an image is being loaded for
+    export class CancellationSource final
+    {
+    public:
+        CancellationSource() noexcept
+            : m_State(new CancellationState())
+        {}
+
+        CancellationSource(const CancellationSource &) = delete;
+        CancellationSource & operator=(const CancellationSource &) = delete;
+
+        CancellationSource(CancellationSource && rhs) noexcept
+            : m_State(std::exchange(rhs.m_State, nullptr))
+        {}
+
+        CancellationSource & operator=(CancellationSource && rhs) noexcept
+        {
+            CancellationSource moved(std::move(rhs));
+            std::swap(m_State, moved.m_State);
+            return *this;
+        }
+
+        ~CancellationSource() noexcept
+        {
+            if (m_State)
+            {
+                m_State->Release();
+            }
+        }
+
+        [[nodiscard]] CancellationToken GetToken() const noexcept
+        {
+            return m_State ? CancellationToken(m_State) : CancellationToken();
+        }
+
+        void Cancel() noexcept
+        {
+            if (m_State)
+            {
+                m_State->Cancel();
+            }
+        }
+
+        [[nodiscard]] bool IsCancellationRequested() const noexcept
+        {
+            return m_State && m_State->IsCancelled();
+        }
+
+    private:
+        CancellationState * m_State = nullptr;
+    };
+}
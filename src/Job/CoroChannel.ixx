@@ -0,0 +1,314 @@
+module;
+
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+export module YT:CoroChannel;
+
+import :Types;
+import :Coroutine;
+import :CoroWaitQueue;
+
+namespace YT
+{
+    /**
+     * @brief Bounded multi-producer multi-consumer channel for coroutines.
+     *
+     * Sending to a full channel or receiving from an empty one suspends the coroutine instead of blocking its
+     * thread. Values are handed straight to a waiting receiver when there is one, and waiters resume on their
+     * own thread context. After Close, receivers drain what is left and then get an empty Optional, and senders
+     * get false.
+     *
+     * @tparam T Element type
+     * @tparam Capacity Number of values buffered before senders suspend
+     */
+    export template <typename T, std::size_t Capacity>
+    class CoroChannel final
+    {
+        static_assert(Capacity > 0, "CoroChannel requires Capacity > 0");
+        static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+            "CoroChannel requires a nothrow movable T");
+
+        struct SendAwaiter : CoroWaitNode
+        {
+            SendAwaiter(CoroChannel * channel, T && value) noexcept
+                : m_Channel(channel)
+                , m_Value(std::move(value))
+            {}
+
+            CoroChannel * m_Channel = nullptr;
+            T m_Value;
+            bool m_Sent = false;
+
+            static constexpr bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            template <typename PromiseType>
+            [[nodiscard]] bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+            {
+                SetContinuation(continuation);
+                return m_Channel->SendOrEnqueue(this);
+            }
+
+            /// @return false if the channel was closed and the value was dropped
+            [[nodiscard]] bool await_resume() const noexcept
+            {
+                return m_Sent;
+            }
+        };
+
+        struct ReceiveAwaiter : CoroWaitNode
+        {
+            CoroChannel * m_Channel = nullptr;
+            Optional<T> m_Value;
+
+            static constexpr bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            template <typename PromiseType>
+            [[nodiscard]] bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+            {
+                SetContinuation(continuation);
+                return m_Channel->ReceiveOrEnqueue(this);
+            }
+
+            /// @return The value, or nothing once the channel is closed and drained
+            [[nodiscard]] Optional<T> await_resume() noexcept
+            {
+                return std::move(m_Value);
+            }
+        };
+
+    public:
+        CoroChannel() noexcept = default;
+
+        CoroChannel(const CoroChannel &) = delete;
+        CoroChannel(CoroChannel &&) = delete;
+        CoroChannel & operator=(const CoroChannel &) = delete;
+        CoroChannel & operator=(CoroChannel &&) = delete;
+
+        ~CoroChannel()
+        {
+            const std::scoped_lock lock(m_Lock);
+            assert(m_Senders.Empty() && m_Receivers.Empty() && "CoroChannel destroyed with pending waiters");
+        }
+
+        /// co_await channel.Send(value), false if the channel is closed
+        [[nodiscard]] SendAwaiter Send(T value) noexcept
+        {
+            return SendAwaiter(this, std::move(value));
+        }
+
+        /// co_await channel.Receive(), empty once the channel is closed and drained
+        [[nodiscard]] ReceiveAwaiter Receive() noexcept
+        {
+            ReceiveAwaiter awaiter;
+            awaiter.m_Channel = this;
+            return awaiter;
+        }
+
+        /// Never suspends, false if the channel is full or closed. value is only moved from on success.
+        [[nodiscard]] bool TrySend(T & value) noexcept
+        {
+            CoroBase * wake = nullptr;
+            {
+                const std::scoped_lock lock(m_Lock);
+                if (m_Closed || (m_Size == Capacity && m_Receivers.Empty()))
+                {
+                    return false;
+                }
+
+                wake = PushLocked(value);
+            }
+
+            if (wake)
+            {
+                wake->EnqueueCoroutineResume();
+            }
+            return true;
+        }
+
+        /// Never suspends, empty if nothing is buffered
+        [[nodiscard]] Optional<T> TryReceive() noexcept
+        {
+            Optional<T> value;
+            CoroBase * wake = nullptr;
+            {
+                const std::scoped_lock lock(m_Lock);
+                if (m_Size == 0)
+                {
+                    return {};
+                }
+
+                wake = PopLocked(value);
+            }
+
+            if (wake)
+            {
+                wake->EnqueueCoroutineResume();
+            }
+            return value;
+        }
+
+        /// Wakes every waiter, buffered values can still be received
+        void Close() noexcept
+        {
+            CoroWaitQueue<SendAwaiter> senders;
+            CoroWaitQueue<ReceiveAwaiter> receivers;
+            {
+                const std::scoped_lock lock(m_Lock);
+                m_Closed = true;
+                std::swap(senders, m_Senders);
+                std::swap(receivers, m_Receivers);
+            }
+
+            while (SendAwaiter * sender = senders.Pop())
+            {
+                sender->m_Sent = false;
+                sender->GetCoro()->EnqueueCoroutineResume();
+            }
+
+            // Receivers only wait on an empty channel, so there is nothing left for them
+            while (ReceiveAwaiter * receiver = receivers.Pop())
+            {
+                receiver->GetCoro()->EnqueueCoroutineResume();
+            }
+        }
+
+        [[nodiscard]] bool IsClosed() const noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            return m_Closed;
+        }
+
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            return m_Size;
+        }
+
+        static consteval std::size_t MaxSize() noexcept
+        {
+            return Capacity;
+        }
+
+    private:
+        /**
+         * @brief Hands the value to a waiting receiver or buffers it. Needs the lock and room in the buffer.
+         *
+         * @return The receiver to resume once the lock is dropped, if any
+         */
+        [[nodiscard]] CoroBase * PushLocked(T & value) noexcept
+        {
+            if (ReceiveAwaiter * receiver = m_Receivers.Pop())
+            {
+                receiver->m_Value.emplace(std::move(value));
+                return receiver->GetCoro();
+            }
+
+            assert(m_Size < Capacity);
+            m_Buffer[(m_Head + m_Size) % Capacity] = std::move(value);
+            ++m_Size;
+            return nullptr;
+        }
+
+        /**
+         * @brief Takes the oldest buffered value and refills the slot from a waiting sender. Needs the lock and a value.
+         *
+         * @return The sender to resume once the lock is dropped, if any
+         */
+        [[nodiscard]] CoroBase * PopLocked(Optional<T> & out) noexcept
+        {
+            assert(m_Size > 0);
+            out.emplace(std::move(*m_Buffer[m_Head]));
+            m_Buffer[m_Head].reset();
+            m_Head = (m_Head + 1) % Capacity;
+            --m_Size;
+
+            if (SendAwaiter * sender = m_Senders.Pop())
+            {
+                m_Buffer[(m_Head + m_Size) % Capacity] = std::move(sender->m_Value);
+                ++m_Size;
+                sender->m_Sent = true;
+                return sender->GetCoro();
+            }
+
+            return nullptr;
+        }
+
+        /// @return true if the sender was queued and should suspend
+        [[nodiscard]] bool SendOrEnqueue(SendAwaiter * sender) noexcept
+        {
+            CoroBase * wake = nullptr;
+            {
+                const std::scoped_lock lock(m_Lock);
+                if (m_Closed)
+                {
+                    sender->m_Sent = false;
+                    return false;
+                }
+
+                if (m_Size == Capacity && m_Receivers.Empty())
+                {
+                    m_Senders.Push(sender);
+                    return true;
+                }
+
+                wake = PushLocked(sender->m_Value);
+                sender->m_Sent = true;
+            }
+
+            if (wake)
+            {
+                wake->EnqueueCoroutineResume();
+            }
+            return false;
+        }
+
+        /// @return true if the receiver was queued and should suspend
+        [[nodiscard]] bool ReceiveOrEnqueue(ReceiveAwaiter * receiver) noexcept
+        {
+            CoroBase * wake = nullptr;
+            {
+                const std::scoped_lock lock(m_Lock);
+                if (m_Size == 0)
+                {
+                    if (m_Closed)
+                    {
+                        return false;
+                    }
+
+                    m_Receivers.Push(receiver);
+                    return true;
+                }
+
+                wake = PopLocked(receiver->m_Value);
+            }
+
+            if (wake)
+            {
+                wake->EnqueueCoroutineResume();
+            }
+            return false;
+        }
+
+    private:
+        mutable CoroSpinLock m_Lock{};
+        std::array<Optional<T>, Capacity> m_Buffer = {};
+        std::size_t m_Head = 0;
+        std::size_t m_Size = 0;
+        bool m_Closed = false;
+        CoroWaitQueue<SendAwaiter> m_Senders;
+        CoroWaitQueue<ReceiveAwaiter> m_Receivers;
+    };
+}
@@ -0,0 +1,270 @@
+module;
+
+//import_std
+
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+export module YT:CoroCombinators;
+
+import :Types;
+import :JobTypes;
+import :Coroutine;
+
+namespace YT
+{
+    export template <typename T>
+    concept CoroType = std::derived_from<T, CoroBase> && requires { typename T::ResultType; };
+
+    /// How a child's result is handed back by WhenAll/WhenAny, void results become std::monostate
+    export template <typename T>
+    using WhenResult = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    template <CoroType CoroT>
+    WhenResult<typename CoroT::ResultType> TakeWhenResult(CoroT & coro) noexcept
+    {
+        if constexpr (std::is_void_v<typename CoroT::ResultType>)
+        {
+            return {};
+        }
+        else
+        {
+            return coro.GetResult();
+        }
+    }
+
+    /**
+     * @brief Awaitable returned by WhenAll.
+     *
+     * Starts every child when awaited, each on its own thread context, and resumes the awaiting coroutine once,
+     * on its own context, after the last child has finished.
+     */
+    export template <CoroType... Coros>
+    class [[nodiscard]] WhenAllAwaitable final
+    {
+    public:
+        explicit WhenAllAwaitable(Coros &&... coros) noexcept
+            : m_Coros(std::move(coros)...)
+        {
+        }
+
+        WhenAllAwaitable(const WhenAllAwaitable &) = delete;
+        WhenAllAwaitable(WhenAllAwaitable &&) = delete;
+        WhenAllAwaitable & operator=(const WhenAllAwaitable &) = delete;
+        WhenAllAwaitable & operator=(WhenAllAwaitable &&) = delete;
+
+        [[nodiscard]] static bool await_ready() noexcept
+        {
+            return sizeof...(Coros) == 0;
+        }
+
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+        {
+            m_Counters.m_Waiter = continuation.promise().m_Coro;
+            m_Counters.m_Outstanding.fetch_add(sizeof...(Coros), std::memory_order_relaxed);
+
+            const CoroBase & parent = *continuation.promise().m_Coro;
+            std::apply([this, &parent](Coros &... coros)
+            {
+                (coros.InheritCancellation(parent), ...);
+                (coros.RunFromList(&m_Counters), ...);
+            }, m_Coros);
+
+            // Drop the reference that kept the children from resuming us while we were still starting them
+            return m_Counters.m_Outstanding.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        std::tuple<WhenResult<typename Coros::ResultType>...> await_resume() noexcept
+        {
+            return std::apply([](Coros &... coros)
+            {
+                return std::tuple<WhenResult<typename Coros::ResultType>...>{ TakeWhenResult(coros)... };
+            }, m_Coros);
+        }
+
+    private:
+        JobCompletionTrackingInfo m_Counters;
+        std::tuple<Coros...> m_Coros;
+    };
+
+    /**
+     * @brief Runs every child concurrently and resumes with all of their results.
+     *
+     * @param coros The children, which may target any mix of thread contexts
+     * @return An awaitable producing a tuple with one result per child, in argument order
+     */
+    export template <CoroType... Coros>
+    [[nodiscard]] WhenAllAwaitable<Coros...> WhenAll(Coros &&... coros) noexcept
+    {
+        return WhenAllAwaitable<Coros...>(std::move(coros)...);
+    }
+
+    /// Result of WhenAny, the index of the child that finished first and its result
+    export template <typename... ResultTypes>
+    struct WhenAnyResult
+    {
+        std::size_t m_Index = 0;
+        std::variant<WhenResult<ResultTypes>...> m_Result;  ///< Holds the alternative at m_Index
+    };
+
+    /**
+     * @brief Shared state of a WhenAny, kept alive until the awaiting coroutine and every child are done with it.
+     *
+     * Children that lose the race keep running after the awaiting coroutine has moved on, the last one out
+     * destroys the state and with it every child's frame.
+     */
+    template <CoroType... Coros>
+    struct WhenAnyState final : JobCompletionTrackingInfo
+    {
+        using ResultType = WhenAnyResult<typename Coros::ResultType...>;
+
+        static constexpr std::size_t NoWinner = std::numeric_limits<std::size_t>::max();
+
+        explicit WhenAnyState(Coros &&... coros) noexcept
+            : m_Coros(std::move(coros)...)
+        {
+            m_OnJobComplete = &OnJobComplete;
+        }
+
+        void Release() noexcept
+        {
+            if (m_Outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+
+        /// The first finisher and the launching coroutine each drop one, whoever is second resumes the waiter
+        bool ReleaseResumeGate() noexcept
+        {
+            return m_ResumeGate.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        template <std::size_t... Indices>
+        [[nodiscard]] std::size_t IndexOf(const CoroBase & coro, std::index_sequence<Indices...>) const noexcept
+        {
+            std::size_t index = NoWinner;
+            ((static_cast<const CoroBase *>(&std::get<Indices>(m_Coros)) == &coro ? (void)(index = Indices) : (void)0), ...);
+            return index;
+        }
+
+        template <std::size_t... Indices>
+        [[nodiscard]] ResultType TakeWinner(std::index_sequence<Indices...>) noexcept
+        {
+            const std::size_t winner = m_Winner.load(std::memory_order_acquire);
+
+            Optional<ResultType> result;
+            ((winner == Indices ? (void)result.emplace(ResultType{ Indices,
+                decltype(ResultType::m_Result)(std::in_place_index<Indices>, TakeWhenResult(std::get<Indices>(m_Coros))) }) : (void)0), ...);
+
+            return std::move(*result);
+        }
+
+        static void OnJobComplete(JobCompletionTrackingInfo & counters, CoroBase & coro) noexcept
+        {
+            WhenAnyState & state = static_cast<WhenAnyState &>(counters);
+
+            std::size_t no_winner = NoWinner;
+            const std::size_t index = state.IndexOf(coro, std::index_sequence_for<Coros...>{});
+            if (state.m_Winner.compare_exchange_strong(no_winner, index, std::memory_order_acq_rel) && state.ReleaseResumeGate())
+            {
+                state.m_Waiter->ResumeWaiter();
+            }
+
+            // May destroy coro's frame, which is fine since it is parked in its final suspend
+            state.Release();
+        }
+
+        std::tuple<Coros...> m_Coros;
+        std::atomic_size_t m_Winner = NoWinner;
+        std::atomic_uint32_t m_ResumeGate = 2;
+    };
+
+    /**
+     * @brief Awaitable returned by WhenAny.
+     *
+     * Starts every child when awaited and resumes the awaiting coroutine once, on its own context, as soon as the
+     * first child finishes. The other children keep running to completion in the background.
+     */
+    export template <CoroType... Coros>
+    class [[nodiscard]] WhenAnyAwaitable final
+    {
+        static_assert(sizeof...(Coros) > 0, "WhenAny needs at least one coroutine");
+
+        using State = WhenAnyState<Coros...>;
+
+    public:
+        explicit WhenAnyAwaitable(Coros &&... coros)
+            : m_State(new State(std::move(coros)...))
+        {
+        }
+
+        WhenAnyAwaitable(const WhenAnyAwaitable &) = delete;
+        WhenAnyAwaitable(WhenAnyAwaitable &&) = delete;
+        WhenAnyAwaitable & operator=(const WhenAnyAwaitable &) = delete;
+        WhenAnyAwaitable & operator=(WhenAnyAwaitable &&) = delete;
+
+        ~WhenAnyAwaitable() noexcept
+        {
+            if (m_State)
+            {
+                m_State->Release();
+            }
+        }
+
+        [[nodiscard]] static bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+        {
+            State * state = m_State;
+            state->m_Waiter = continuation.promise().m_Coro;
+            state->m_Outstanding.fetch_add(sizeof...(Coros), std::memory_order_relaxed);
+
+            const CoroBase & parent = *continuation.promise().m_Coro;
+            std::apply([state, &parent](Coros &... coros)
+            {
+                (coros.InheritCancellation(parent), ...);
+                (coros.RunFromList(state), ...);
+            }, state->m_Coros);
+
+            // If a child already won while we were starting the others, carry on without suspending
+            return !state->ReleaseResumeGate();
+        }
+
+        typename State::ResultType await_resume() noexcept
+        {
+            State * state = std::exchange(m_State, nullptr);
+            typename State::ResultType result = state->TakeWinner(std::index_sequence_for<Coros...>{});
+            state->Release();
+            return result;
+        }
+
+    private:
+        State * m_State = nullptr;
+    };
+
+    /**
+     * @brief Runs every child concurrently and resumes as soon as the first one finishes.
+     *
+     * @param coros The children, which may target any mix of thread contexts
+     * @return An awaitable producing the index of the first child to finish and its result
+     */
+    export template <CoroType... Coros>
+    [[nodiscard]] WhenAnyAwaitable<Coros...> WhenAny(Coros &&... coros)
+    {
+        return WhenAnyAwaitable<Coros...>(std::move(coros)...);
+    }
+}
@@ -1,17 +1,25 @@
 module;
 
+#include <atomic>
 #include <cassert>
 #include <coroutine>
-#include <mutex>
 #include <new>
 
 export module YT:CoroEvent;
 
 import :Types;
 import :Coroutine;
+import :CoroWaitQueue;
 
 namespace YT
 {
+    /**
+     * @brief One-shot event that resumes every waiting coroutine when triggered.
+     *
+     * The whole state is one atomic word: nullptr when untriggered with no waiters, this when triggered, and
+     * otherwise the head of an intrusive stack of waiters that live in the awaiting coroutine frames. Waiting
+     * and triggering take no locks and never allocate.
+     */
     export class CoroEvent final
     {
     public:
@@ -24,62 +32,78 @@ namespace YT
 
         ~CoroEvent()
         {
-            const std::scoped_lock lock(m_Mutex);
-            assert(m_Waiters.empty() && "CoroEvent destroyed with pending waiters");
+            [[maybe_unused]] const void * state = m_State.load(std::memory_order_acquire);
+            assert((state == nullptr || state == TriggeredState()) && "CoroEvent destroyed with pending waiters");
         }
 
         [[nodiscard]] bool IsTriggered() const noexcept
         {
-            const std::scoped_lock lock(m_Mutex);
-            return m_Triggered;
+            return m_State.load(std::memory_order_acquire) == TriggeredState();
         }
 
         void Trigger() noexcept
         {
-            Vector<CoroBase **> wake{};
+            void * const state = m_State.exchange(TriggeredState(), std::memory_order_acq_rel);
+            if (state == TriggeredState())
             {
-                const std::scoped_lock lock(m_Mutex);
-                if (m_Triggered)
-                {
-                    return;
-                }
-                m_Triggered = true;
-                wake.swap(m_Waiters);
+                return;
             }
 
-            for (CoroBase ** waiter : wake)
+            // Waiters were pushed as a stack, flip it so they resume in the order they arrived
+            CoroWaitNode * waiters = nullptr;
+            for (CoroWaitNode * node = static_cast<CoroWaitNode *>(state); node != nullptr; )
             {
-                if (waiter && *waiter)
-                {
-                    (*waiter)->EnqueueCoroutineResume();
-                }
+                CoroWaitNode * const next = node->m_Next;
+                node->m_Next = waiters;
+                waiters = node;
+                node = next;
+            }
+
+            while (waiters)
+            {
+                // The node lives in the waiter's frame, so step past it before resuming
+                CoroWaitNode * const waiter = waiters;
+                waiters = waiter->m_Next;
+                waiter->GetCoro()->EnqueueCoroutineResume();
             }
         }
 
+        /// Only rearms a triggered event, waiters queued since are left alone
         void Reset() noexcept
         {
-            const std::scoped_lock lock(m_Mutex);
-            m_Triggered = false;
+            void * expected = TriggeredState();
+            m_State.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel, std::memory_order_relaxed);
         }
 
-        bool TryEnqueueWaiter(CoroBase ** coro) noexcept
+        /// @return false if the event is already triggered and the waiter should not suspend
+        bool TryEnqueueWaiter(CoroWaitNode * waiter) noexcept
         {
-            const std::scoped_lock lock(m_Mutex);
-            if (m_Triggered)
+            void * state = m_State.load(std::memory_order_acquire);
+            do
             {
-                return false;
+                if (state == TriggeredState())
+                {
+                    return false;
+                }
+
+                waiter->m_Next = static_cast<CoroWaitNode *>(state);
             }
-            m_Waiters.push_back(coro);
+            while (!m_State.compare_exchange_weak(state, waiter, std::memory_order_release, std::memory_order_acquire));
+
             return true;
         }
 
     private:
-        mutable Mutex m_Mutex{};
-        bool m_Triggered = false;
-        Vector<CoroBase **> m_Waiters = {};
+        [[nodiscard]] void * TriggeredState() const noexcept
+        {
+            return const_cast<CoroEvent *>(this);
+        }
+
+    private:
+        std::atomic<void *> m_State = nullptr;
     };
 
-    export class CoroEventWait final
+    export class CoroEventWait final : CoroWaitNode
     {
     public:
         explicit CoroEventWait(CoroEvent & event) noexcept
@@ -94,8 +118,8 @@ namespace YT
         template <typename PromiseType>
         [[nodiscard]] bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
         {
-            assert(continuation.promise().m_Coro != nullptr);
-            return m_Event->TryEnqueueWaiter(&continuation.promise().m_Coro);
+            SetContinuation(continuation);
+            return m_Event->TryEnqueueWaiter(this);
         }
 
         static void await_resume() noexcept {}
@@ -0,0 +1,184 @@
+module;
+
+#include <cassert>
+#include <coroutine>
+#include <mutex>
+#include <utility>
+
+export module YT:CoroMutex;
+
+import :Types;
+import :Coroutine;
+import :CoroWaitQueue;
+
+namespace YT
+{
+    export class CoroMutex;
+
+    /// Unlocks a CoroMutex when it goes out of scope, returned by co_await mutex.ScopedLock()
+    export class CoroLockGuard final
+    {
+    public:
+        CoroLockGuard() noexcept = default;
+
+        explicit CoroLockGuard(CoroMutex & mutex) noexcept
+            : m_Mutex(&mutex)
+        {}
+
+        CoroLockGuard(const CoroLockGuard &) = delete;
+        CoroLockGuard & operator=(const CoroLockGuard &) = delete;
+
+        CoroLockGuard(CoroLockGuard && rhs) noexcept
+            : m_Mutex(std::exchange(rhs.m_Mutex, nullptr))
+        {}
+
+        CoroLockGuard & operator=(CoroLockGuard && rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                Unlock();
+                m_Mutex = std::exchange(rhs.m_Mutex, nullptr);
+            }
+            return *this;
+        }
+
+        ~CoroLockGuard() noexcept
+        {
+            Unlock();
+        }
+
+        inline void Unlock() noexcept;
+
+    private:
+        CoroMutex * m_Mutex = nullptr;
+    };
+
+    /**
+     * @brief Mutex for coroutines.
+     *
+     * A coroutine that can't take the lock suspends instead of blocking its thread. Unlock hands ownership
+     * straight to the oldest waiter, which resumes on its own thread context.
+     */
+    export class CoroMutex final
+    {
+        struct LockAwaiter : CoroWaitNode
+        {
+            CoroMutex * m_Mutex = nullptr;
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return m_Mutex->TryLock();
+            }
+
+            template <typename PromiseType>
+            [[nodiscard]] bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+            {
+                SetContinuation(continuation);
+                return m_Mutex->LockOrEnqueue(this);
+            }
+
+            static void await_resume() noexcept {}
+        };
+
+        struct ScopedLockAwaiter : LockAwaiter
+        {
+            [[nodiscard]] CoroLockGuard await_resume() const noexcept
+            {
+                return CoroLockGuard(*m_Mutex);
+            }
+        };
+
+    public:
+        CoroMutex() noexcept = default;
+
+        CoroMutex(const CoroMutex &) = delete;
+        CoroMutex(CoroMutex &&) = delete;
+        CoroMutex & operator=(const CoroMutex &) = delete;
+        CoroMutex & operator=(CoroMutex &&) = delete;
+
+        ~CoroMutex()
+        {
+            const std::scoped_lock lock(m_Lock);
+            assert(!m_Locked && m_Waiters.Empty() && "CoroMutex destroyed while locked");
+        }
+
+        [[nodiscard]] bool TryLock() noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            if (m_Locked)
+            {
+                return false;
+            }
+            m_Locked = true;
+            return true;
+        }
+
+        /// co_await mutex.Lock(), then call Unlock when done
+        [[nodiscard]] LockAwaiter Lock() noexcept
+        {
+            LockAwaiter awaiter;
+            awaiter.m_Mutex = this;
+            return awaiter;
+        }
+
+        /// auto guard = co_await mutex.ScopedLock()
+        [[nodiscard]] ScopedLockAwaiter ScopedLock() noexcept
+        {
+            ScopedLockAwaiter awaiter;
+            awaiter.m_Mutex = this;
+            return awaiter;
+        }
+
+        void Unlock() noexcept
+        {
+            CoroBase * next = nullptr;
+            {
+                const std::scoped_lock lock(m_Lock);
+                assert(m_Locked);
+
+                if (CoroWaitNode * waiter = m_Waiters.Pop())
+                {
+                    // Ownership passes to the waiter, so the mutex stays locked
+                    next = waiter->GetCoro();
+                }
+                else
+                {
+                    m_Locked = false;
+                }
+            }
+
+            if (next)
+            {
+                next->EnqueueCoroutineResume();
+            }
+        }
+
+    private:
+        /// @return true if the coroutine was queued and should suspend, false if it took the lock
+        [[nodiscard]] bool LockOrEnqueue(CoroWaitNode * waiter) noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            if (!m_Locked)
+            {
+                m_Locked = true;
+                return false;
+            }
+
+            m_Waiters.Push(waiter);
+            return true;
+        }
+
+    private:
+        CoroSpinLock m_Lock{};
+        bool m_Locked = false;
+        CoroWaitQueue<> m_Waiters;
+    };
+
+    void CoroLockGuard::Unlock() noexcept
+    {
+        if (CoroMutex * mutex = std::exchange(m_Mutex, nullptr))
+        {
+            mutex->Unlock();
+        }
+    }
+}
@@ -0,0 +1,128 @@
+module;
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+
+export module YT:CoroSemaphore;
+
+import :Types;
+import :Coroutine;
+import :CoroWaitQueue;
+
+namespace YT
+{
+    /**
+     * @brief Counting semaphore for coroutines.
+     *
+     * Acquiring with no permits left suspends the coroutine instead of blocking its thread. Release hands
+     * permits straight to the oldest waiters, which resume on their own thread context.
+     */
+    export class CoroSemaphore final
+    {
+        struct AcquireAwaiter : CoroWaitNode
+        {
+            CoroSemaphore * m_Semaphore = nullptr;
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return m_Semaphore->TryAcquire();
+            }
+
+            template <typename PromiseType>
+            [[nodiscard]] bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+            {
+                SetContinuation(continuation);
+                return m_Semaphore->AcquireOrEnqueue(this);
+            }
+
+            static void await_resume() noexcept {}
+        };
+
+    public:
+        explicit CoroSemaphore(std::size_t initial_count = 0) noexcept
+            : m_Count(initial_count)
+        {}
+
+        CoroSemaphore(const CoroSemaphore &) = delete;
+        CoroSemaphore(CoroSemaphore &&) = delete;
+        CoroSemaphore & operator=(const CoroSemaphore &) = delete;
+        CoroSemaphore & operator=(CoroSemaphore &&) = delete;
+
+        ~CoroSemaphore()
+        {
+            const std::scoped_lock lock(m_Lock);
+            assert(m_Waiters.Empty() && "CoroSemaphore destroyed with pending waiters");
+        }
+
+        [[nodiscard]] bool TryAcquire() noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            if (m_Count == 0)
+            {
+                return false;
+            }
+            --m_Count;
+            return true;
+        }
+
+        /// co_await semaphore.Acquire()
+        [[nodiscard]] AcquireAwaiter Acquire() noexcept
+        {
+            AcquireAwaiter awaiter;
+            awaiter.m_Semaphore = this;
+            return awaiter;
+        }
+
+        void Release(std::size_t count = 1) noexcept
+        {
+            CoroWaitQueue<> wake;
+            {
+                const std::scoped_lock lock(m_Lock);
+                for (; count > 0; --count)
+                {
+                    CoroWaitNode * waiter = m_Waiters.Pop();
+                    if (!waiter)
+                    {
+                        break;
+                    }
+                    wake.Push(waiter);
+                }
+                m_Count += count;
+            }
+
+            // Pop before resuming, each node dies with its coroutine's await
+            while (CoroWaitNode * waiter = wake.Pop())
+            {
+                waiter->GetCoro()->EnqueueCoroutineResume();
+            }
+        }
+
+        [[nodiscard]] std::size_t GetAvailable() const noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            return m_Count;
+        }
+
+    private:
+        /// @return true if the coroutine was queued and should suspend, false if it took a permit
+        [[nodiscard]] bool AcquireOrEnqueue(CoroWaitNode * waiter) noexcept
+        {
+            const std::scoped_lock lock(m_Lock);
+            if (m_Count > 0)
+            {
+                --m_Count;
+                return false;
+            }
+
+            m_Waiters.Push(waiter);
+            return true;
+        }
+
+    private:
+        mutable CoroSpinLock m_Lock{};
+        std::size_t m_Count = 0;
+        CoroWaitQueue<> m_Waiters;
+    };
+}
@@ -0,0 +1,114 @@
+module;
+
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+
+export module YT:CoroWaitQueue;
+
+import :Coroutine;
+import :Wait;
+
+namespace YT
+{
+    /// A suspended coroutine waiting on a primitive, lives in the awaiter so queueing never allocates
+    export struct CoroWaitNode
+    {
+        CoroBase ** m_Coro = nullptr;       ///< The promise's coroutine pointer, it follows the coroutine if it moves
+        CoroWaitNode * m_Next = nullptr;
+
+        template <typename PromiseType>
+        void SetContinuation(std::coroutine_handle<PromiseType> continuation) noexcept
+        {
+            assert(continuation.promise().m_Coro != nullptr);
+            m_Coro = &continuation.promise().m_Coro;
+        }
+
+        /// Read before dropping the primitive's lock, the node may be gone once the coroutine resumes
+        [[nodiscard]] CoroBase * GetCoro() const noexcept
+        {
+            return *m_Coro;
+        }
+    };
+
+    /**
+     * @brief Lock guarding a primitive's wait queue, usable with std::scoped_lock.
+     *
+     * Everything done under it is a few pointer swaps or a single move, so a contender spins and yields instead of
+     * sleeping in the kernel the way a std::mutex would. No OS thread is ever parked on a coroutine primitive.
+     */
+    export class CoroSpinLock final
+    {
+    public:
+        void lock() noexcept
+        {
+            while (m_Locked.exchange(true, std::memory_order_acquire))
+            {
+                AtomicWait(m_Locked, true, AtomicWaitBoundedPolicy);
+            }
+        }
+
+        [[nodiscard]] bool try_lock() noexcept
+        {
+            return !m_Locked.load(std::memory_order_relaxed) && !m_Locked.exchange(true, std::memory_order_acquire);
+        }
+
+        void unlock() noexcept
+        {
+            m_Locked.store(false, std::memory_order_release);
+        }
+
+    private:
+        std::atomic_bool m_Locked = false;
+    };
+
+    /**
+     * @brief Intrusive FIFO of waiting coroutines.
+     *
+     * Not thread-safe by itself, the owning primitive guards it with its own lock.
+     *
+     * @tparam NodeType The awaiter type, must derive from CoroWaitNode
+     */
+    export template <std::derived_from<CoroWaitNode> NodeType = CoroWaitNode>
+    class CoroWaitQueue final
+    {
+    public:
+        [[nodiscard]] bool Empty() const noexcept
+        {
+            return m_Head == nullptr;
+        }
+
+        void Push(NodeType * node) noexcept
+        {
+            node->m_Next = nullptr;
+            if (m_Tail)
+            {
+                m_Tail->m_Next = node;
+            }
+            else
+            {
+                m_Head = node;
+            }
+            m_Tail = node;
+        }
+
+        [[nodiscard]] NodeType * Pop() noexcept
+        {
+            CoroWaitNode * const node = m_Head;
+            if (node)
+            {
+                m_Head = node->m_Next;
+                if (!m_Head)
+                {
+                    m_Tail = nullptr;
+                }
+            }
+            return static_cast<NodeType *>(node);
+        }
+
+    private:
+        CoroWaitNode * m_Head = nullptr;
+        CoroWaitNode * m_Tail = nullptr;
+    };
+}
@@ -6,6 +6,7 @@ module;
 #include <atomic>
 #include <thread>
 #include <array>
+#include <bit>
 #include <coroutine>
 #include <concepts>
 #include <memory>
@@ -19,18 +20,55 @@ export module YT:Coroutine;
 import :Types;
 import :JobTypes;
 import :Wait;
+import :Cancellation;
 
 namespace YT
 {
     export ThreadContextType GetCurrentThreadContext() noexcept;
     export void SetCurrentThreadContext(ThreadContextType context) noexcept;
 
+    /// Priority of the job currently running on this thread, inherited by jobs it starts without an explicit priority
+    export JobPriority GetCurrentJobPriority() noexcept;
+    export void SetCurrentJobPriority(JobPriority priority) noexcept;
+
     export void MakeThreadLocalCoroutineAllocator() noexcept;
 
+    /// Coroutine frames up to the largest class are carved from thread-cached blocks, bigger ones go to malloc
+    export constexpr std::array<std::size_t, 5> CoroutineSizeClasses = { 64, 128, 256, 512, 1024 };
+    export constexpr std::size_t NumCoroutineSizeClasses = CoroutineSizeClasses.size();
+
+    /// Size class blocks are aligned to this, frames asking for more alignment go to aligned_alloc
+    export constexpr std::size_t CoroutineBlockAlignment = 64;
+
+    export struct CoroutineAllocatorClassStats
+    {
+        std::size_t m_BlockSize = 0;
+        std::uint64_t m_Hits = 0;       ///< Frames served from the allocating thread's cache
+        std::uint64_t m_Misses = 0;     ///< Frames that fell through to the shared pool
+    };
+
+    /// Snapshot of coroutine frame allocations summed over every thread
+    export struct CoroutineAllocatorStats
+    {
+        std::array<CoroutineAllocatorClassStats, NumCoroutineSizeClasses> m_Classes = {};
+        std::uint64_t m_Oversized = 0;  ///< Frames too large or too aligned for any size class
+    };
+
+    export [[nodiscard]] CoroutineAllocatorStats GetCoroutineAllocatorStats() noexcept;
+
     void * AllocateCoroutine(std::size_t size, std::align_val_t alignment) noexcept;
-    void FreeCoroutine(void * ptr, std::size_t size) noexcept;
+    void FreeCoroutine(void * ptr, std::size_t size, std::align_val_t alignment) noexcept;
+
+    /**
+     * @brief Runs one round of pending work on the calling thread while it blocks on something else.
+     *
+     * Job threads and the main thread run a queued job, the main thread also drains its own queue. Other threads
+     * have nothing they can safely run and just get false back.
+     *
+     * @return true if anything ran, so the caller should check its condition again before sleeping
+     */
+    bool HelpWhileWaiting() noexcept;
 
-    void RunMainThreadJobsIfNeeded();
     void ExecuteSynchronousCoroutineIfNeeded() noexcept;
 
     export template <typename ReturnType>
@@ -60,11 +98,59 @@ namespace YT
         void Resume() const noexcept;
         void RunFromList(JobCompletionTrackingInfo * tracking_block) noexcept;
 
+        /// Starts the coroutine and blocks until it completes, helping like CoroBundle::WaitForCompletion and
+        /// likewise never parking, so it keeps a core busy on CPUs without umwait/mwaitx
         void RunSynchronous();
         void EnqueueCoroutineResume() noexcept;
 
+        /**
+         * @brief Resumes this coroutine on its own thread context after something it awaits has completed.
+         *
+         * Unlike EnqueueCoroutineResume this never resumes inline, same thread resumes are deferred until the
+         * current coroutine has returned control, which makes it safe to call from a FinalSuspend.
+         */
+        void ResumeWaiter() noexcept;
+
+        [[nodiscard]] JobPriority GetPriority() const noexcept
+        {
+            return m_Priority;
+        }
+
+        [[nodiscard]] const CancellationToken & GetCancellationToken() const noexcept
+        {
+            return m_Cancellation;
+        }
+
+        [[nodiscard]] bool IsCancellationRequested() const noexcept
+        {
+            return m_Cancellation.IsCancellationRequested();
+        }
+
+        /// Picks up the awaiting coroutine's token unless this one was given its own
+        void InheritCancellation(const CoroBase & parent) noexcept
+        {
+            if (!m_Cancellation)
+            {
+                m_Cancellation = parent.m_Cancellation;
+            }
+        }
+
     protected:
 
+        /// Returns to the awaiting coroutine only once this one is fully suspended, so it can be destroyed right away
+        struct FinalSuspend
+        {
+            static bool await_ready() noexcept { return false; }
+
+            template <typename PromiseType>
+            void await_suspend(std::coroutine_handle<PromiseType> coroutine) noexcept
+            {
+                coroutine.promise().m_Coro->ScheduleBackward();
+            }
+
+            static void await_resume() noexcept {}
+        };
+
         void ScheduleForward() noexcept;
         void ScheduleBackward() noexcept;
 
@@ -85,11 +171,13 @@ namespace YT
         std::coroutine_handle<> m_ReturnHandle = {};
         ThreadContextType m_ReturnType = {};
         JobCompletionTrackingInfo * m_IncrementCounters = nullptr;
-        std::thread::id m_OwningThread = {};
-        Mutex * m_Mutex = nullptr;
+        std::atomic_bool * m_SyncComplete = nullptr;     ///< Set by ScheduleBackward when run through RunSynchronous
         void * m_Promise = nullptr;
         void * m_ResultPtr = nullptr;
         CoroBase ** m_PromiseCoroPtr = nullptr;
+        CancellationToken m_Cancellation;
+        JobPriority m_Priority = JobPriority::Normal;
+        bool m_HasExplicitPriority : 1 = false;
         bool m_Started : 1 = false;
         bool m_Complete : 1 = false;
         bool m_HasReturnValue : 1 = false;
@@ -108,6 +196,8 @@ namespace YT
 
         static_assert(ThreadType != ThreadContextType::Unknown, "ThreadType must be ThreadContextType::Unknown");
 
+        using ResultType = ReturnType;
+
         struct promise_type
         {
             CoroBase * m_Coro = nullptr;
@@ -137,7 +227,7 @@ namespace YT
             static auto get_return_object_on_allocation_failure() noexcept { return Coro(); }
 
             static std::suspend_always initial_suspend() noexcept { return {}; }
-            static std::suspend_always final_suspend() noexcept { return {}; }
+            static FinalSuspend final_suspend() noexcept { return {}; }
 
             template <typename ReturnValueType>
             void return_value(ReturnValueType && value) noexcept
@@ -150,12 +240,12 @@ namespace YT
 
                 Coro * coro = static_cast<Coro *>(m_Coro);
                 coro->m_HasReturnValue = true;
-                coro->ScheduleBackward();
             }
 
             void * operator new(std::size_t size) noexcept { return AllocateCoroutine(size, {}); }
             void * operator new(std::size_t size, std::align_val_t alignment) noexcept { return AllocateCoroutine(size, alignment); }
-            void operator delete (void * ptr, std::size_t size) noexcept { FreeCoroutine(ptr, size); }
+            void operator delete (void * ptr, std::size_t size) noexcept { FreeCoroutine(ptr, size, {}); }
+            void operator delete (void * ptr, std::size_t size, std::align_val_t alignment) noexcept { FreeCoroutine(ptr, size, alignment); }
         };
 
         Coro()
@@ -180,6 +270,25 @@ namespace YT
         Coro & operator=(const Coro & rhs) = delete;
         Coro & operator=(Coro && rhs) = default;
 
+        /**
+         * @brief Sets the lane this coroutine is scheduled in when it runs on the job threads.
+         *
+         * Without this the coroutine inherits the priority of whichever job starts it.
+         */
+        Coro && WithPriority(JobPriority priority) && noexcept
+        {
+            m_Priority = priority;
+            m_HasExplicitPriority = true;
+            return std::move(*this);
+        }
+
+        /// Attaches a cancellation token, coroutines this one awaits inherit it
+        Coro && WithCancellation(CancellationToken token) && noexcept
+        {
+            m_Cancellation = std::move(token);
+            return std::move(*this);
+        }
+
         ReturnType GetResult() noexcept
         {
             promise_type * promise = static_cast<promise_type *>(m_Promise);
@@ -189,16 +298,42 @@ namespace YT
         }
 
         static bool await_ready() noexcept { return false; }
-        void await_suspend(std::coroutine_handle<> coro) noexcept
+
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> coro) noexcept
         {
+            if constexpr (requires { coro.promise().m_Coro; })
+            {
+                InheritCancellation(*coro.promise().m_Coro);
+            }
+
+            // Cancelled, so never start this one and hand back a default result instead. Without a default result
+            // there is nothing to hand back, so the child runs regardless.
+            if constexpr (std::default_initializable<ReturnType>)
+            {
+                if (IsCancellationRequested())
+                {
+                    return false;
+                }
+            }
+
             m_ReturnHandle = coro;
             m_ReturnType = GetCurrentThreadContext();
             ScheduleForward();
+            return true;
         }
 
         ReturnType await_resume() noexcept
             requires(std::move_constructible<ReturnType>)
         {
+            if constexpr (std::default_initializable<ReturnType>)
+            {
+                if (!m_Started)
+                {
+                    return ReturnType{};
+                }
+            }
+
             promise_type * promise = static_cast<promise_type *>(m_Promise);
 
             ReturnType * result = reinterpret_cast<ReturnType *>(&promise->m_ReturnStorage.m_Array);
@@ -213,6 +348,8 @@ namespace YT
 
         static_assert(ThreadType != ThreadContextType::Unknown, "ThreadType must be ThreadContextType::Unknown");
 
+        using ResultType = void;
+
         struct promise_type
         {
             CoroBase * m_Coro = nullptr;
@@ -226,18 +363,18 @@ namespace YT
             static auto get_return_object_on_allocation_failure() noexcept { return Coro(); }
 
             static std::suspend_always initial_suspend() noexcept { return {}; }
-            static std::suspend_always final_suspend() noexcept { return {}; }
+            static FinalSuspend final_suspend() noexcept { return {}; }
 
             void return_void() noexcept
             {
                 Coro * const coro = static_cast<Coro *>(m_Coro);
                 coro->m_HasReturnValue = true;
-                coro->ScheduleBackward();
             }
 
             void * operator new(std::size_t size) noexcept { return AllocateCoroutine(size, {}); }
             void * operator new(std::size_t size, std::align_val_t alignment) noexcept { return AllocateCoroutine(size, alignment); }
-            void operator delete (void * ptr, std::size_t size) noexcept { FreeCoroutine(ptr, size); }
+            void operator delete (void * ptr, std::size_t size) noexcept { FreeCoroutine(ptr, size, {}); }
+            void operator delete (void * ptr, std::size_t size, std::align_val_t alignment) noexcept { FreeCoroutine(ptr, size, alignment); }
         };
 
         Coro()
@@ -262,17 +399,76 @@ namespace YT
         Coro & operator=(const Coro & rhs) = delete;
         Coro & operator=(Coro && rhs) = default;
 
+        /**
+         * @brief Sets the lane this coroutine is scheduled in when it runs on the job threads.
+         *
+         * Without this the coroutine inherits the priority of whichever job starts it.
+         */
+        Coro && WithPriority(JobPriority priority) && noexcept
+        {
+            m_Priority = priority;
+            m_HasExplicitPriority = true;
+            return std::move(*this);
+        }
+
+        /// Attaches a cancellation token, coroutines this one awaits inherit it
+        Coro && WithCancellation(CancellationToken token) && noexcept
+        {
+            m_Cancellation = std::move(token);
+            return std::move(*this);
+        }
+
         static bool await_ready() noexcept { return false; }
-        void await_suspend(std::coroutine_handle<> coro) noexcept
+
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> coro) noexcept
         {
+            if constexpr (requires { coro.promise().m_Coro; })
+            {
+                InheritCancellation(*coro.promise().m_Coro);
+            }
+
+            // Cancelled, so never start this one
+            if (IsCancellationRequested())
+            {
+                return false;
+            }
+
             m_ReturnHandle = coro;
             m_ReturnType = GetCurrentThreadContext();
             ScheduleForward();
+            return true;
         }
 
         static void await_resume() noexcept {}
     };
 
+    /**
+     * @brief co_await CurrentCancellationToken() yields the awaiting coroutine's own token without suspending.
+     *
+     * For polling inside long running coroutines, e.g. before kicking off an upload whose result nobody wants.
+     */
+    export class CurrentCancellationToken final
+    {
+    public:
+        static bool await_ready() noexcept { return false; }
+
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> coro) noexcept
+        {
+            m_Token = coro.promise().m_Coro->GetCancellationToken();
+            return false;
+        }
+
+        [[nodiscard]] CancellationToken await_resume() noexcept
+        {
+            return std::move(m_Token);
+        }
+
+    private:
+        CancellationToken m_Token;
+    };
+
     template <typename ReturnType>
     class CoroBundle final
     {
@@ -284,9 +480,17 @@ namespace YT
         CoroBundle & operator=(const CoroBundle &) = delete;
         CoroBundle & operator=(CoroBundle &&) = delete;
 
+        /**
+         * @brief Allocates room for count jobs up front.
+         *
+         * Optional, the bundle grows on its own without moving the jobs it already holds.
+         */
         void Reserve(std::size_t count)
         {
-            m_OwnedJobs.reserve(count);
+            while (m_Capacity < count)
+            {
+                AddChunk();
+            }
         }
 
         /**
@@ -298,41 +502,90 @@ namespace YT
         template <ThreadContextType ThreadType>
         void PushJob(Coro<ReturnType, ThreadType> && coro) noexcept
         {
-            // We have to pre-reserve the entire array so we have stable pointers
-            assert(m_OwnedJobs.size() < m_OwnedJobs.capacity());
+            if (m_NumJobs == m_Capacity)
+            {
+                AddChunk();
+            }
+
+            CoroBase & list_coro = GetJob(m_NumJobs++);
+            list_coro = std::move(coro);
 
-            m_Target++;
-            CoroBase & list_coro = m_OwnedJobs.emplace_back(std::forward<CoroBase>(coro));
+            m_Counters.m_Outstanding.fetch_add(1, std::memory_order_relaxed);
             list_coro.RunFromList(&m_Counters);
         }
 
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            return m_NumJobs;
+        }
+
+        [[nodiscard]] bool IsComplete() const noexcept
+        {
+            return m_Counters.m_Outstanding.load(std::memory_order_acquire) == 1;
+        }
+
         /**
          * @brief Waits for all jobs in the list to complete.
          *
-         * Blocks until the completion counter reaches the target value.
+         * Blocks the calling thread until every job has finished, running other pending jobs in the meantime so a
+         * job thread waiting on children queued behind it doesn't stall. From a coroutine prefer co_await.
+         *
+         * Never parks. The last job may still be touching the counters when we see it finish, so it can't notify
+         * us, and nothing signals new work for us to help with. On CPUs without umwait/mwaitx the wait between
+         * checks is a pause and a yield, which keeps the core busy for as long as the jobs run.
          */
         void WaitForCompletion() const noexcept
         {
-            if (m_OwnedJobs.empty())
+            if (IsComplete())
             {
                 return;
             }
 
             while (true)
             {
-                RunMainThreadJobsIfNeeded();
+                if (HelpWhileWaiting())
+                {
+                    if (IsComplete())
+                    {
+                        break;
+                    }
 
-                MonitorAddr(&m_Counters.m_RemoteCount);
+                    continue;
+                }
 
-                if (m_Counters.m_LocalCount + m_Counters.m_RemoteCount >= m_Target)
+                const std::size_t outstanding = m_Counters.m_Outstanding.load(std::memory_order_acquire);
+                if (outstanding == 1)
                 {
                     break;
                 }
 
-                WaitForAddr(150000);
+                // Bounded, the last job may touch the counters after we see 1 and return, so nobody can notify us
+                AtomicWait(m_Counters.m_Outstanding, outstanding, AtomicWaitBoundedPolicy);
             }
         }
 
+        /// co_await on the bundle suspends the calling coroutine until every job pushed so far has finished
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return IsComplete();
+        }
+
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+        {
+            m_Counters.m_Waiter = continuation.promise().m_Coro;
+
+            // Drop the bundle's own reference, if that was the last one every job already finished and we carry on
+            return m_Counters.m_Outstanding.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        void await_resume() noexcept
+        {
+            // Take the bundle's reference back so it can be pushed to and awaited again
+            m_Counters.m_Waiter = nullptr;
+            m_Counters.m_Outstanding.store(1, std::memory_order_relaxed);
+        }
+
         /**
          * @brief Returns the result of a job at the specified index.
          *
@@ -343,19 +596,40 @@ namespace YT
         std::add_lvalue_reference_t<ReturnType> operator[](std::size_t index)
             requires (!std::same_as<ReturnType, void>)
         {
-            return *static_cast<ReturnType *>(m_OwnedJobs[index].GetResultPtr());
+            return *static_cast<ReturnType *>(GetJob(index).GetResultPtr());
         }
 
         std::add_lvalue_reference_t<const ReturnType> operator[](std::size_t index) const
             requires (!std::same_as<ReturnType, void>)
         {
-            return *static_cast<const ReturnType *>(m_OwnedJobs[index].GetResultPtr());
+            return *static_cast<const ReturnType *>(GetJob(index).GetResultPtr());
+        }
+
+    private:
+
+        static constexpr std::size_t FirstChunkSize = 8;
+
+        /// Chunks double in size and are never reallocated, so workers can keep pointers to the jobs
+        void AddChunk()
+        {
+            const std::size_t chunk_size = FirstChunkSize << m_Chunks.size();
+            m_Chunks.emplace_back(std::make_unique<CoroBase[]>(chunk_size));
+            m_Capacity += chunk_size;
+        }
+
+        [[nodiscard]] CoroBase & GetJob(std::size_t index) const noexcept
+        {
+            // Chunk n holds FirstChunkSize << n jobs, starting at index FirstChunkSize * (2^n - 1)
+            const std::size_t chunk = static_cast<std::size_t>(std::bit_width(index / FirstChunkSize + 1)) - 1;
+            const std::size_t offset = index - FirstChunkSize * ((std::size_t{1} << chunk) - 1);
+            return m_Chunks[chunk][offset];
         }
 
     private:
-        Vector<CoroBase> m_OwnedJobs;
+        Vector<UniquePtr<CoroBase[]>> m_Chunks;
+        std::size_t m_NumJobs = 0;
+        std::size_t m_Capacity = 0;
         JobCompletionTrackingInfo m_Counters;
-        int m_Target = 0;
     };
 
     export template <typename ReturnType = void>
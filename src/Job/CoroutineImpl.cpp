@@ -1,7 +1,14 @@
 module;
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
 #include <memory>
+#include <mutex>
 #include <coroutine>
+#include <cstdint>
 #include <new>
 #include <cassert>
 #include <thread>
@@ -16,14 +23,47 @@ import :JobManager;
 import :BackgroundTaskManager;
 import :FileMapper;
 import :WorkerThread;
+import :JobTrace;
+import :DeterministicScheduler;
+import :Wait;
 
 namespace YT
 {
     thread_local ThreadContextType g_ThreadContextType = ThreadContextType::Unknown;
     thread_local std::coroutine_handle<> g_SynchronousCoroutineHandle = {};
+    thread_local JobPriority g_CurrentJobPriority = JobPriority::Normal;
 
-    static constexpr std::size_t MaxCoroAllocSize = 128;
-    ThreadCachedFixedBlockAllocator<std::uint64_t[MaxCoroAllocSize / 8], 4096, 65536> g_CoroAllocator;
+    template <std::size_t BlockSize>
+    struct alignas(CoroutineBlockAlignment) CoroBlock
+    {
+        std::byte m_Data[BlockSize];
+    };
+
+    static_assert(std::ranges::all_of(CoroutineSizeClasses, [](std::size_t size) { return size % CoroutineBlockAlignment == 0; }),
+        "Coroutine size classes must keep blocks packed at CoroutineBlockAlignment");
+
+    // Smaller frames are far more common, so those classes get the bigger caches. Every pool thread reserves the
+    // initial blocks of each class up front, the big classes start small and grow only on threads that use them.
+    ThreadCachedFixedBlockAllocator<CoroBlock<CoroutineSizeClasses[0]>, 4096, 65536> g_CoroAllocator64;
+    ThreadCachedFixedBlockAllocator<CoroBlock<CoroutineSizeClasses[1]>, 4096, 65536> g_CoroAllocator128;
+    ThreadCachedFixedBlockAllocator<CoroBlock<CoroutineSizeClasses[2]>, 1024, 16384> g_CoroAllocator256;
+    ThreadCachedFixedBlockAllocator<CoroBlock<CoroutineSizeClasses[3]>, 128, 8192> g_CoroAllocator512;
+    ThreadCachedFixedBlockAllocator<CoroBlock<CoroutineSizeClasses[4]>, 64, 4096> g_CoroAllocator1024;
+
+    static constexpr std::size_t OversizedCoroClass = NumCoroutineSizeClasses;
+
+    /// Only ever written by the owning thread, so the counters are bumped without read-modify-write. Each thread's
+    /// stats get their own cache lines, they're written on every allocation.
+    struct alignas(64) CoroAllocatorThreadStats
+    {
+        std::array<std::atomic_uint64_t, NumCoroutineSizeClasses> m_Hits = {};
+        std::array<std::atomic_uint64_t, NumCoroutineSizeClasses> m_Misses = {};
+        std::atomic_uint64_t m_Oversized = 0;
+    };
+
+    Mutex g_CoroAllocatorStatsMutex;
+    Vector<UniquePtr<CoroAllocatorThreadStats>> g_CoroAllocatorStats;  ///< Never shrinks, so stats outlive their thread
+    thread_local CoroAllocatorThreadStats * g_CoroAllocatorThreadStats = nullptr;
 
 
     ThreadContextType GetCurrentThreadContext() noexcept
@@ -36,42 +76,145 @@ namespace YT
         g_ThreadContextType = context;
     }
 
-    void * AllocateCoroutine(std::size_t size, std::align_val_t alignment) noexcept
+    JobPriority GetCurrentJobPriority() noexcept
+    {
+        return g_CurrentJobPriority;
+    }
+
+    void SetCurrentJobPriority(JobPriority priority) noexcept
     {
-        void * p;
-        if (size <= MaxCoroAllocSize)
+        g_CurrentJobPriority = priority;
+    }
+
+    CoroAllocatorThreadStats & GetCoroAllocatorThreadStats() noexcept
+    {
+        if (!g_CoroAllocatorThreadStats)
         {
-            p = g_CoroAllocator.Allocate();
+            const std::scoped_lock lock(g_CoroAllocatorStatsMutex);
+            g_CoroAllocatorThreadStats = g_CoroAllocatorStats.emplace_back(MakeUnique<CoroAllocatorThreadStats>()).get();
         }
-        else
+
+        return *g_CoroAllocatorThreadStats;
+    }
+
+    void IncrementCoroAllocatorStat(std::atomic_uint64_t & counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /// Both allocation and free route through here, so a frame always goes back to the class it came from
+    [[nodiscard]] std::size_t GetCoroSizeClass(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        if (size > CoroutineSizeClasses.back() || static_cast<std::size_t>(alignment) > CoroutineBlockAlignment)
         {
-            p = std::malloc(size);
+            return OversizedCoroClass;
         }
+
+        if (size <= CoroutineSizeClasses.front())
+        {
+            return 0;
+        }
+
+        return static_cast<std::size_t>(std::bit_width(size - 1) - std::bit_width(CoroutineSizeClasses.front() - 1));
+    }
+
+    void * AllocateCoroutine(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        const std::size_t size_class = GetCoroSizeClass(size, alignment);
+        CoroAllocatorThreadStats & stats = GetCoroAllocatorThreadStats();
+
+        void * p = nullptr;
+        bool local_hit = false;
+        switch (size_class)
+        {
+            case 0: p = g_CoroAllocator64.Allocate(local_hit); break;
+            case 1: p = g_CoroAllocator128.Allocate(local_hit); break;
+            case 2: p = g_CoroAllocator256.Allocate(local_hit); break;
+            case 3: p = g_CoroAllocator512.Allocate(local_hit); break;
+            case 4: p = g_CoroAllocator1024.Allocate(local_hit); break;
+            default:
+            {
+                IncrementCoroAllocatorStat(stats.m_Oversized);
+
+                const std::size_t align = static_cast<std::size_t>(alignment);
+                if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                {
+                    return std::malloc(size);
+                }
+
+                // aligned_alloc wants the size to be a multiple of the alignment
+                return std::aligned_alloc(align, (size + align - 1) & ~(align - 1));
+            }
+        }
+
+        IncrementCoroAllocatorStat(local_hit ? stats.m_Hits[size_class] : stats.m_Misses[size_class]);
         return p;
     }
 
-    void FreeCoroutine(void * ptr, std::size_t size) noexcept
+    void FreeCoroutine(void * ptr, std::size_t size, std::align_val_t alignment) noexcept
     {
-        if (size <= MaxCoroAllocSize)
+        switch (GetCoroSizeClass(size, alignment))
         {
-            g_CoroAllocator.Free(ptr);
-            return;
+            case 0: g_CoroAllocator64.Free(ptr); break;
+            case 1: g_CoroAllocator128.Free(ptr); break;
+            case 2: g_CoroAllocator256.Free(ptr); break;
+            case 3: g_CoroAllocator512.Free(ptr); break;
+            case 4: g_CoroAllocator1024.Free(ptr); break;
+            default: std::free(ptr); break;
         }
+    }
 
-        std::free(ptr);
+    CoroutineAllocatorStats GetCoroutineAllocatorStats() noexcept
+    {
+        CoroutineAllocatorStats result;
+        for (std::size_t index = 0; index < NumCoroutineSizeClasses; ++index)
+        {
+            result.m_Classes[index].m_BlockSize = CoroutineSizeClasses[index];
+        }
+
+        const std::scoped_lock lock(g_CoroAllocatorStatsMutex);
+        for (const UniquePtr<CoroAllocatorThreadStats> & stats : g_CoroAllocatorStats)
+        {
+            for (std::size_t index = 0; index < NumCoroutineSizeClasses; ++index)
+            {
+                result.m_Classes[index].m_Hits += stats->m_Hits[index].load(std::memory_order_relaxed);
+                result.m_Classes[index].m_Misses += stats->m_Misses[index].load(std::memory_order_relaxed);
+            }
+
+            result.m_Oversized += stats->m_Oversized.load(std::memory_order_relaxed);
+        }
+
+        return result;
     }
 
-    void RunMainThreadJobsIfNeeded()
+    bool HelpWhileWaiting() noexcept
     {
+        if (g_DeterministicScheduler)
+        {
+            return g_DeterministicScheduler->RunNext();
+        }
+
+        bool ran = false;
         if (GetCurrentThreadContext() == ThreadContextType::Main)
         {
-            g_MainThreadQueue.TryExecuteWork();
+            ran = g_MainThreadQueue.TryExecuteWork() > 0;
         }
+
+        if (g_JobManager && g_JobManager->TryRunPendingJob())
+        {
+            ran = true;
+        }
+
+        return ran;
     }
 
     void MakeThreadLocalCoroutineAllocator() noexcept
     {
-        g_CoroAllocator.MakeLocalAllocator();
+        g_CoroAllocator64.MakeLocalAllocator();
+        g_CoroAllocator128.MakeLocalAllocator();
+        g_CoroAllocator256.MakeLocalAllocator();
+        g_CoroAllocator512.MakeLocalAllocator();
+        g_CoroAllocator1024.MakeLocalAllocator();
     }
 
     void SetSynchronousCoroutineHandle(std::coroutine_handle<> handle) noexcept
@@ -94,17 +237,20 @@ namespace YT
         , m_ReturnHandle(std::exchange(rhs.m_ReturnHandle, {}))
         , m_ReturnType(std::exchange(rhs.m_ReturnType, ThreadContextType::Unknown))
         , m_IncrementCounters(std::exchange(rhs.m_IncrementCounters, nullptr))
-        , m_OwningThread(std::exchange(rhs.m_OwningThread, std::thread::id{}))
-        , m_Mutex(std::exchange(rhs.m_Mutex, nullptr))
+        , m_SyncComplete(std::exchange(rhs.m_SyncComplete, nullptr))
         , m_Promise(std::exchange(rhs.m_Promise, nullptr))
         , m_ResultPtr(std::exchange(rhs.m_ResultPtr, nullptr))
         , m_PromiseCoroPtr(std::exchange(rhs.m_PromiseCoroPtr, nullptr))
+        , m_Cancellation(std::move(rhs.m_Cancellation))
+        , m_Priority(std::exchange(rhs.m_Priority, JobPriority::Normal))
     {
         assert(!rhs.m_Started);
         // Bit-fields cannot bind to `std::exchange` reference parameters.
+        m_HasExplicitPriority = rhs.m_HasExplicitPriority;
         m_Started = rhs.m_Started;
         m_Complete = rhs.m_Complete;
         m_HasReturnValue = rhs.m_HasReturnValue;
+        rhs.m_HasExplicitPriority = false;
         rhs.m_Started = false;
         rhs.m_Complete = false;
         rhs.m_HasReturnValue = false;
@@ -131,15 +277,18 @@ namespace YT
             m_ReturnHandle = std::exchange(rhs.m_ReturnHandle, {});
             m_ReturnType = std::exchange(rhs.m_ReturnType, ThreadContextType::Unknown);
             m_IncrementCounters = std::exchange(rhs.m_IncrementCounters, nullptr);
-            m_OwningThread = std::exchange(rhs.m_OwningThread, std::thread::id{});
-            m_Mutex = std::exchange(rhs.m_Mutex, nullptr);
+            m_SyncComplete = std::exchange(rhs.m_SyncComplete, nullptr);
             m_Promise = std::exchange(rhs.m_Promise, nullptr);
             m_ResultPtr = std::exchange(rhs.m_ResultPtr, nullptr);
             m_PromiseCoroPtr = std::exchange(rhs.m_PromiseCoroPtr, nullptr);
+            m_Cancellation = std::move(rhs.m_Cancellation);
+            m_Priority = std::exchange(rhs.m_Priority, JobPriority::Normal);
             // Bit-fields cannot bind to `std::exchange` reference parameters.
+            m_HasExplicitPriority = rhs.m_HasExplicitPriority;
             m_Started = rhs.m_Started;
             m_Complete = rhs.m_Complete;
             m_HasReturnValue = rhs.m_HasReturnValue;
+            rhs.m_HasExplicitPriority = false;
             rhs.m_Started = false;
             rhs.m_Complete = false;
             rhs.m_HasReturnValue = false;
@@ -164,21 +313,31 @@ namespace YT
     void CoroBase::RunFromList(JobCompletionTrackingInfo * tracking_block) noexcept
     {
         m_IncrementCounters = tracking_block;
-        m_OwningThread = std::this_thread::get_id();
 
         ScheduleForward();
     }
 
     void CoroBase::RunSynchronous()
     {
-        Mutex mutex;
-        m_Mutex = &mutex;
-        m_Mutex->lock();
+        std::atomic_bool complete = false;
+        m_SyncComplete = &complete;
 
         ScheduleForward();
-        m_Mutex->lock();
 
-        m_Mutex = nullptr;
+        while (!complete.load(std::memory_order_acquire))
+        {
+            if (HelpWhileWaiting())
+            {
+                continue;
+            }
+
+            assert(!g_DeterministicScheduler && "RunSynchronous coroutine can never complete in deterministic mode");
+
+            // complete lives on our stack, so the resuming thread can't notify it without racing our return
+            AtomicWait(complete, false, AtomicWaitBoundedPolicy);
+        }
+
+        m_SyncComplete = nullptr;
     }
 
     void CoroBase::ScheduleForward() noexcept
@@ -188,6 +347,11 @@ namespace YT
 
         m_ReturnType = GetCurrentThreadContext();
 
+        if (!m_HasExplicitPriority)
+        {
+            m_Priority = GetCurrentJobPriority();
+        }
+
         Schedule(m_CoroutineType, m_CoroutineHandle, true);
         ExecuteSynchronousCoroutineIfNeeded();
     }
@@ -197,28 +361,39 @@ namespace YT
         Schedule(m_CoroutineType, m_CoroutineHandle, true);
     }
 
+    void CoroBase::ResumeWaiter() noexcept
+    {
+        Schedule(m_CoroutineType, m_CoroutineHandle, false);
+    }
+
     void CoroBase::ScheduleBackward() noexcept
     {
         assert(!m_Complete);
         m_Complete = true;
 
-        if (m_IncrementCounters)
+        // Whoever we signal below may destroy this coroutine straight away, so nothing can touch members after that
+        std::atomic_bool * const sync_complete = m_SyncComplete;
+        JobCompletionTrackingInfo * const counters = m_IncrementCounters;
+
+        TraceJobEvent(JobTraceEventType::Complete, this, m_CoroutineType, static_cast<std::uint8_t>(m_Priority));
+        Schedule(m_ReturnType, m_ReturnHandle, false);
+
+        if (counters)
         {
-            if (m_OwningThread == std::this_thread::get_id())
+            if (counters->m_OnJobComplete)
             {
-                m_IncrementCounters->m_LocalCount++;
+                counters->m_OnJobComplete(*counters, *this);
             }
-            else
+            else if (counters->m_Outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
             {
-                m_IncrementCounters->m_RemoteCount.fetch_add(1, std::memory_order_relaxed);
+                // Last job of a group that a coroutine is awaiting
+                counters->m_Waiter->ResumeWaiter();
             }
         }
 
-        Schedule(m_ReturnType, m_ReturnHandle, false);
-
-        if (m_Mutex)
+        if (sync_complete)
         {
-            m_Mutex->unlock();
+            sync_complete->store(true, std::memory_order_release);
         }
     }
 
@@ -248,13 +423,25 @@ namespace YT
 
         if (coroutine)
         {
-            if (thread_context == ThreadContextType::Main && GetCurrentThreadContext() == ThreadContextType::Main)
+            TraceJobEvent(JobTraceEventType::Schedule, this, thread_context, static_cast<std::uint8_t>(m_Priority));
+
+            if (g_DeterministicScheduler)
+            {
+                // Every context goes through the one seeded queue, even resumes that could happen inline
+                g_DeterministicScheduler->Push(thread_context, [this] { Resume(); });
+            }
+            else if (thread_context == ThreadContextType::Main && GetCurrentThreadContext() == ThreadContextType::Main)
             {
                 TrySyncResume();
             }
-            else if (thread_context == ThreadContextType::Main || thread_context == ThreadContextType::Job)
+            else if (thread_context == ThreadContextType::Main)
             {
-                g_JobManager->PushJob(*this);
+                // Picked up by the frame loop's budgeted drain, or by the main thread helping while it blocks
+                g_MainThreadQueue.PushWork([this] { Resume(); });
+            }
+            else if (thread_context == ThreadContextType::Job)
+            {
+                g_JobManager->PushJob(*this, m_Priority);
             }
             else if (thread_context == ThreadContextType::Background)
             {
@@ -282,6 +469,10 @@ namespace YT
 
     void CoroBase::Resume() const noexcept
     {
+        // The coroutine may be destroyed while it runs, so the end event only uses copies
+        const ThreadContextType trace_context = m_CoroutineType;
+        TraceJobEvent(JobTraceEventType::ResumeBegin, this, trace_context);
+
         if (!m_Complete)
         {
             if (m_CoroutineHandle)
@@ -296,6 +487,7 @@ namespace YT
             m_ReturnHandle.resume();
         }
 
+        TraceJobEvent(JobTraceEventType::ResumeEnd, this, trace_context);
         ExecuteSynchronousCoroutineIfNeeded();
     }
 
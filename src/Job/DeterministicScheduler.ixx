@@ -0,0 +1,106 @@
+module;
+
+//import_std
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+export module YT:DeterministicScheduler;
+
+import :Types;
+import :JobTypes;
+
+namespace YT
+{
+    /// One task run by the DeterministicScheduler, in the order they ran
+    export struct DeterministicTraceEntry
+    {
+        std::uint64_t m_TaskId = 0;         ///< Order the task was pushed in, stable between runs with the same seed
+        std::uint64_t m_VirtualTime = 0;    ///< Virtual time the task started at
+        std::uint64_t m_CostNs = 0;         ///< Wall time spent in the task, including anything it ran nested
+        ThreadContextType m_Context = ThreadContextType::Unknown;
+    };
+
+    /**
+     * @brief Runs every thread context's work on the calling thread in a seeded, reproducible order.
+     *
+     * When enabled (ApplicationInitInfo::m_DeterministicScheduling) every coroutine resume, whatever context it
+     * targets, is pushed here instead of to the job, background, file mapper or FreeType queues. The main thread
+     * then picks ready tasks one at a time with a seeded generator, so a given seed and workload always produce the
+     * same interleaving and the same trace. Virtual time advances by one per task, and each task's wall time is
+     * recorded against it so cost can be attributed without other threads muddying the numbers.
+     *
+     * Push can be called from any thread, but tasks only run from RunNext/RunUntilIdle on the driving thread.
+     */
+    export class DeterministicScheduler final
+    {
+    public:
+        explicit DeterministicScheduler(std::uint64_t seed) noexcept;
+
+        DeterministicScheduler(const DeterministicScheduler &) = delete;
+        DeterministicScheduler(DeterministicScheduler &&) = delete;
+        DeterministicScheduler & operator=(const DeterministicScheduler &) = delete;
+        DeterministicScheduler & operator=(DeterministicScheduler &&) = delete;
+
+        /**
+         * @brief Queues work to run as though it were on a thread of the given context.
+         *
+         * @param context The thread context the work would normally run on, set as current while it runs
+         * @param work The work to run
+         */
+        void Push(ThreadContextType context, WorkFunction && work);
+
+        /// Runs one ready task picked by the seeded generator, returns false if nothing was ready
+        bool RunNext();
+
+        /// Runs ready tasks, including ones they push, until none are left. Returns how many ran.
+        std::size_t RunUntilIdle();
+
+        [[nodiscard]] std::size_t GetNumReadyTasks() const noexcept;
+
+        [[nodiscard]] std::uint64_t GetVirtualTime() const noexcept
+        {
+            return m_VirtualTime;
+        }
+
+        [[nodiscard]] Span<const DeterministicTraceEntry> GetTrace() const noexcept
+        {
+            return m_Trace;
+        }
+
+        /// Hash of the order tasks ran in and their contexts, equal between runs that scheduled identically
+        [[nodiscard]] std::uint64_t GetTraceHash() const noexcept;
+
+        /// Total wall time spent in tasks of a context, nested tasks count towards their caller as well
+        [[nodiscard]] std::uint64_t GetContextCostNs(ThreadContextType context) const noexcept;
+
+        void ClearTrace() noexcept;
+
+    private:
+        struct Task
+        {
+            std::uint64_t m_Id = 0;
+            ThreadContextType m_Context = ThreadContextType::Unknown;
+            WorkFunction m_Work;
+        };
+
+        /// splitmix64, so the pick order doesn't depend on the standard library's distributions
+        [[nodiscard]] std::uint64_t NextRandom() noexcept;
+
+    private:
+        static constexpr std::size_t NumContexts = static_cast<std::size_t>(ThreadContextType::FreeType) + 1;
+
+        mutable std::mutex m_Mutex;             ///< Guards m_Ready and m_NextTaskId, Push may come from other threads
+        Vector<Task> m_Ready;
+        std::uint64_t m_NextTaskId = 0;
+
+        std::uint64_t m_RandomState = 0;
+        std::uint64_t m_VirtualTime = 0;
+        Vector<DeterministicTraceEntry> m_Trace;
+        std::array<std::uint64_t, NumContexts> m_ContextCostNs = {};
+    };
+
+    export UniquePtr<DeterministicScheduler> g_DeterministicScheduler;
+}
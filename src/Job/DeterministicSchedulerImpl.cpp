@@ -0,0 +1,140 @@
+module;
+
+//import_std
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+module YT:DeterministicSchedulerImpl;
+
+import :Types;
+import :JobTypes;
+import :Coroutine;
+import :DeterministicScheduler;
+
+namespace YT
+{
+    DeterministicScheduler::DeterministicScheduler(std::uint64_t seed) noexcept
+        : m_RandomState(seed)
+    {
+    }
+
+    void DeterministicScheduler::Push(ThreadContextType context, WorkFunction && work)
+    {
+        const std::lock_guard lock(m_Mutex);
+        m_Ready.emplace_back(Task
+        {
+            .m_Id = m_NextTaskId++,
+            .m_Context = context,
+            .m_Work = std::move(work),
+        });
+    }
+
+    bool DeterministicScheduler::RunNext()
+    {
+        Task task;
+        {
+            const std::lock_guard lock(m_Mutex);
+            if (m_Ready.empty())
+            {
+                return false;
+            }
+
+            // Swap the pick to the back so removal is cheap, the shuffle this causes is just as deterministic
+            const std::size_t index = static_cast<std::size_t>(NextRandom() % m_Ready.size());
+            std::swap(m_Ready[index], m_Ready.back());
+            task = std::move(m_Ready.back());
+            m_Ready.pop_back();
+        }
+
+        const std::uint64_t start_time = m_VirtualTime++;
+        const ThreadContextType previous_context = GetCurrentThreadContext();
+        SetCurrentThreadContext(task.m_Context);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        task.m_Work();
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        SetCurrentThreadContext(previous_context);
+
+        const std::uint64_t cost_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        m_Trace.emplace_back(DeterministicTraceEntry
+        {
+            .m_TaskId = task.m_Id,
+            .m_VirtualTime = start_time,
+            .m_CostNs = cost_ns,
+            .m_Context = task.m_Context,
+        });
+
+        const std::size_t context_index = static_cast<std::size_t>(task.m_Context);
+        if (context_index < m_ContextCostNs.size())
+        {
+            m_ContextCostNs[context_index] += cost_ns;
+        }
+
+        return true;
+    }
+
+    std::size_t DeterministicScheduler::RunUntilIdle()
+    {
+        std::size_t num_run = 0;
+        while (RunNext())
+        {
+            ++num_run;
+        }
+
+        return num_run;
+    }
+
+    std::size_t DeterministicScheduler::GetNumReadyTasks() const noexcept
+    {
+        const std::lock_guard lock(m_Mutex);
+        return m_Ready.size();
+    }
+
+    std::uint64_t DeterministicScheduler::GetTraceHash() const noexcept
+    {
+        // FNV-1a over the parts of the trace that don't depend on wall time
+        std::uint64_t hash = 14695981039346656037ull;
+        auto Mix = [&hash](std::uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        for (const DeterministicTraceEntry & entry : m_Trace)
+        {
+            Mix(entry.m_TaskId);
+            Mix(entry.m_VirtualTime);
+            Mix(static_cast<std::uint64_t>(entry.m_Context));
+        }
+
+        return hash;
+    }
+
+    std::uint64_t DeterministicScheduler::GetContextCostNs(ThreadContextType context) const noexcept
+    {
+        const std::size_t context_index = static_cast<std::size_t>(context);
+        return context_index < m_ContextCostNs.size() ? m_ContextCostNs[context_index] : 0;
+    }
+
+    void DeterministicScheduler::ClearTrace() noexcept
+    {
+        m_Trace.clear();
+        m_ContextCostNs = {};
+    }
+
+    std::uint64_t DeterministicScheduler::NextRandom() noexcept
+    {
+        std::uint64_t z = (m_RandomState += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
@@ -12,9 +12,11 @@ module;
 export module YT:FileMapper;
 
 import :Types;
+import :InplaceFunction;
 import :JobTypes;
 import :MultiProducerMultiConsumer;
 import :MultiProducerSingleConsumer;
+import :SpillQueue;
 import :Coroutine;
 
 namespace YT
@@ -46,15 +48,16 @@ namespace YT
         void * m_Data = nullptr;
     };
 
+    /// Called with the mapped file on the FileMapper thread, inline so queueing a request never allocates
+    export using MapFileCallback = InplaceFunction<void(MappedFile &&), 32>;
+
     export class FileMapper final
     {
     public:
 
-        static constexpr std::size_t NumThreads = Threading::NumFileMapperThreads;
-
         static bool CreateFileMapper() noexcept;
 
-        FileMapper() noexcept;
+        explicit FileMapper(std::size_t num_threads);
 
         FileMapper(const FileMapper&) = delete;
         FileMapper(FileMapper&&) = delete;
@@ -63,11 +66,16 @@ namespace YT
 
         ~FileMapper();
 
-        void MapFile(const StringView & file_name, Function<void(MappedFile &&)> && callback) noexcept;
+        void MapFile(const StringView & file_name, MapFileCallback && callback) noexcept;
         void PushCoro(CoroBase * coro) noexcept;
 
         void SyncAll() const noexcept;
 
+        [[nodiscard]] SpillQueueStats GetSpillStats() const noexcept
+        {
+            return m_InputQueue.GetStats();
+        }
+
     private:
 
         void RunThread(int thread_index) noexcept;
@@ -78,7 +86,7 @@ namespace YT
         std::atomic_int m_Requests = 0;
         std::atomic_int m_Responses = 0;
 
-        std::array<std::thread, NumThreads> m_Threads;
+        Vector<std::thread> m_Threads;
         std::counting_semaphore<> m_Semaphore;
 
     private:
@@ -87,10 +95,10 @@ namespace YT
             CoroBase * m_Coro = nullptr;
             String m_FileName;
             bool m_CallbackInThread = false;
-            Function<void(MappedFile &&)> m_Callback;
+            MapFileCallback m_Callback;
         };
 
-        MultiProducerMultiConsumer<InputData, 1024> m_InputQueue;
+        SpillQueue<InputData, 1024> m_InputQueue;
     };
 
     UniquePtr<FileMapper> g_FileMapper;
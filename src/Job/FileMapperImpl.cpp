@@ -18,6 +18,8 @@ module YT:FileMapperImpl;
 
 import :Types;
 import :FileMapper;
+import :JobTrace;
+import :ThreadTopology;
 import :MultiProducerMultiConsumer;
 import :MultiProducerSingleConsumer;
 import :Coroutine;
@@ -117,7 +119,7 @@ namespace YT
 
         try
         {
-            g_FileMapper = MakeUnique<FileMapper>();
+            g_FileMapper = MakeUnique<FileMapper>(Threading::GetNumFileMapperThreads());
             return true;
         }
         catch (...)
@@ -126,18 +128,16 @@ namespace YT
         }
     }
 
-    FileMapper::FileMapper() noexcept :
+    FileMapper::FileMapper(std::size_t num_threads) :
         m_Semaphore(0)
     {
-        int thread_index = 0;
-        for (std::thread & thread : m_Threads)
+        m_Threads.reserve(num_threads);
+        for (std::size_t thread_index = 0; thread_index < num_threads; ++thread_index)
         {
-            thread = std::thread([this, thread_index]()
+            m_Threads.emplace_back([this, thread_index]()
             {
-                RunThread(thread_index);
+                RunThread(static_cast<int>(thread_index));
             });
-
-            ++thread_index;
         }
     }
 
@@ -145,7 +145,7 @@ namespace YT
     {
         m_Running = false;
 
-        m_Semaphore.release(NumThreads);
+        m_Semaphore.release(static_cast<std::ptrdiff_t>(m_Threads.size()));
 
         for (std::thread & thread : m_Threads)
         {
@@ -153,7 +153,7 @@ namespace YT
         }
     }
 
-    void FileMapper::MapFile(const StringView & file_name, Function<void(MappedFile &&)> && callback) noexcept
+    void FileMapper::MapFile(const StringView & file_name, MapFileCallback && callback) noexcept
     {
         InputData input_data
         {
@@ -161,10 +161,7 @@ namespace YT
             .m_Callback = std::move(callback)
         };
 
-        while (!m_InputQueue.TryEnqueue(std::move(input_data)))
-        {
-            std::this_thread::yield();
-        }
+        m_InputQueue.Enqueue(std::move(input_data));
 
         ++m_Requests;
         m_Semaphore.release();
@@ -177,10 +174,7 @@ namespace YT
             .m_Coro = coro
         };
 
-        while (!m_InputQueue.TryEnqueue(std::move(input_data)))
-        {
-            std::this_thread::yield();
-        }
+        m_InputQueue.Enqueue(std::move(input_data));
 
         ++m_Requests;
         m_Semaphore.release();
@@ -190,13 +184,13 @@ namespace YT
     {
         while (true)
         {
-            MonitorAddr(&m_Responses);
-            if (m_Requests.load() == m_Responses.load())
+            const int responses = m_Responses.load(std::memory_order_acquire);
+            if (m_Requests.load(std::memory_order_acquire) == responses)
             {
                 break;
             }
 
-            WaitForAddr(150000);
+            AtomicWait(m_Responses, responses);
         }
     }
 
@@ -204,6 +198,8 @@ namespace YT
     {
         MakeThreadLocalCoroutineAllocator();
         SetCurrentThreadContext(ThreadContextType::FileMapper);
+        SetJobTraceThreadName("FileMapper", thread_index);
+        ApplyThreadAffinity(ThreadPoolType::FileMapper, static_cast<std::size_t>(thread_index));
 
         while (m_Running)
         {
@@ -212,6 +208,9 @@ namespace YT
              InputData input_data;
              if (m_InputQueue.TryDequeue(input_data))
              {
+                 const JobTraceWorkScope trace_scope(input_data.m_Coro ? static_cast<const void *>(input_data.m_Coro) : &input_data,
+                     ThreadContextType::FileMapper);
+
                  if (input_data.m_Coro)
                  {
                      input_data.m_Coro->Resume();
@@ -222,6 +221,7 @@ namespace YT
                  }
 
                  ++m_Responses;
+                 AtomicNotify(m_Responses);
              }
         }
     }
@@ -0,0 +1,149 @@
+module;
+
+//import_std
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+
+export module YT:FrameTiming;
+
+import :Coroutine;
+import :CoroWaitQueue;
+import :TimerWheel;
+
+namespace YT
+{
+    /// Resolution of the frame timers, Delay rounds up to this
+    export using FrameTimerTick = std::chrono::milliseconds;
+
+    [[nodiscard]] std::uint64_t GetFrameTimerTick() noexcept;
+    void ScheduleFrameTimer(TimerWheelNode & node) noexcept;
+
+    enum class FrameSignalType
+    {
+        NextFrame,
+        AfterPresent,
+    };
+
+    void WaitForFrameSignal(FrameSignalType signal, CoroWaitNode & waiter) noexcept;
+
+    /// Fires due timers, called by WindowManager while it waits for the next frame and by RenderManager each frame
+    void AdvanceFrameTimers() noexcept;
+
+    /// Resumes everything waiting on NextFrame, called by WindowManager when a new frame starts
+    void SignalNextFrame() noexcept;
+
+    /// Resumes everything waiting on AfterPresent, called by RenderManager once the frame has been presented
+    void SignalAfterPresent() noexcept;
+
+    /// Where the main thread's time went in the last finished frame, not counting the wait for the next one
+    export struct MainThreadFrameStats
+    {
+        std::uint64_t m_FrameIndex = 0;
+        std::uint64_t m_BusyTimeUs = 0;             ///< Event dispatch, main thread work and rendering
+        std::uint64_t m_WorkTimeUs = 0;             ///< Of which running the main thread queue
+        std::uint32_t m_WorkItemsRun = 0;
+        bool m_WorkLeftOver = false;                ///< The budget ran out with work still queued, it carries to the next frame
+    };
+
+    export [[nodiscard]] MainThreadFrameStats GetMainThreadFrameStats() noexcept;
+
+    /// How long RunMainThreadWork may spend per frame, set from ApplicationInitInfo::m_MainThreadWorkBudgetUs
+    void SetMainThreadWorkBudget(std::chrono::microseconds budget) noexcept;
+    [[nodiscard]] std::chrono::microseconds GetMainThreadWorkBudget() noexcept;
+
+    /// Called by the main loop around everything but WaitForNextFrame to measure the frame's busy time
+    void BeginMainThreadFrame() noexcept;
+    void EndMainThreadFrame() noexcept;
+
+    /// Runs the main thread queue for up to the frame's budget, called once per frame by the main loop.
+    /// Job threads never take from that queue, so the stats below see everything but blocking main thread waits.
+    void RunMainThreadWork() noexcept;
+
+    export class DelayAwaiter final : TimerWheelNode
+    {
+    public:
+        explicit DelayAwaiter(std::uint64_t ticks) noexcept
+            : m_Ticks(ticks)
+        {
+            m_OnExpire = &DelayAwaiter::OnExpire;
+        }
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return m_Ticks == 0;
+        }
+
+        template <typename PromiseType>
+        void await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+        {
+            m_Waiter.SetContinuation(continuation);
+            m_ExpiryTick = GetFrameTimerTick() + m_Ticks;
+            ScheduleFrameTimer(*this);
+        }
+
+        static void await_resume() noexcept {}
+
+    private:
+        static void OnExpire(TimerWheelNode & node) noexcept
+        {
+            static_cast<DelayAwaiter &>(node).m_Waiter.GetCoro()->EnqueueCoroutineResume();
+        }
+
+    private:
+        CoroWaitNode m_Waiter;
+        std::uint64_t m_Ticks = 0;
+    };
+
+    export class FrameAwaiter final
+    {
+    public:
+        explicit FrameAwaiter(FrameSignalType signal) noexcept
+            : m_Signal(signal)
+        {}
+
+        static constexpr bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        template <typename PromiseType>
+        void await_suspend(std::coroutine_handle<PromiseType> continuation) noexcept
+        {
+            m_Waiter.SetContinuation(continuation);
+            WaitForFrameSignal(m_Signal, m_Waiter);
+        }
+
+        static void await_resume() noexcept {}
+
+    private:
+        CoroWaitNode m_Waiter;
+        FrameSignalType m_Signal = FrameSignalType::NextFrame;
+    };
+
+    /**
+     * @brief co_await Delay(duration) resumes the coroutine on its own thread context once duration has passed.
+     *
+     * Timers are checked about once a millisecond by the main loop, so this is meant for animation and
+     * debouncing rather than precise timing.
+     */
+    export template <typename Rep, typename Period>
+    [[nodiscard]] DelayAwaiter Delay(std::chrono::duration<Rep, Period> duration) noexcept
+    {
+        const std::int64_t ticks = std::chrono::ceil<FrameTimerTick>(duration).count();
+        return DelayAwaiter(ticks > 0 ? static_cast<std::uint64_t>(ticks) : 0);
+    }
+
+    /// co_await NextFrame() resumes the coroutine when the main loop starts its next frame
+    export [[nodiscard]] inline FrameAwaiter NextFrame() noexcept
+    {
+        return FrameAwaiter(FrameSignalType::NextFrame);
+    }
+
+    /// co_await AfterPresent() resumes the coroutine once the current frame has been submitted and presented
+    export [[nodiscard]] inline FrameAwaiter AfterPresent() noexcept
+    {
+        return FrameAwaiter(FrameSignalType::AfterPresent);
+    }
+}
@@ -0,0 +1,147 @@
+module;
+
+//import_std
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+module YT:FrameTimingImpl;
+
+import :Coroutine;
+import :CoroWaitQueue;
+import :TimerWheel;
+import :FrameTiming;
+import :WorkerThread;
+import :WorkerThreadQueue;
+
+namespace YT
+{
+    /// Lock-free stack of coroutines waiting for a point in the frame
+    class FrameSignal final
+    {
+    public:
+        void Wait(CoroWaitNode & waiter) noexcept
+        {
+            CoroWaitNode * head = m_Waiters.load(std::memory_order_relaxed);
+            do
+            {
+                waiter.m_Next = head;
+            }
+            while (!m_Waiters.compare_exchange_weak(head, &waiter, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void Signal() noexcept
+        {
+            // Anything that waits again while being resumed lands on the fresh list and waits for the next signal
+            CoroWaitNode * waiters = nullptr;
+            for (CoroWaitNode * node = m_Waiters.exchange(nullptr, std::memory_order_acquire); node != nullptr; )
+            {
+                CoroWaitNode * const next = node->m_Next;
+                node->m_Next = waiters;
+                waiters = node;
+                node = next;
+            }
+
+            while (waiters)
+            {
+                CoroWaitNode * const waiter = waiters;
+                waiters = waiter->m_Next;
+                waiter->GetCoro()->EnqueueCoroutineResume();
+            }
+        }
+
+    private:
+        std::atomic<CoroWaitNode *> m_Waiters = nullptr;
+    };
+
+    const std::chrono::steady_clock::time_point g_FrameTimerStartTime = std::chrono::steady_clock::now();
+    TimerWheel g_FrameTimers;
+    FrameSignal g_NextFrameSignal;
+    FrameSignal g_AfterPresentSignal;
+
+    std::uint64_t GetFrameTimerTick() noexcept
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - g_FrameTimerStartTime;
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<FrameTimerTick>(elapsed).count());
+    }
+
+    void ScheduleFrameTimer(TimerWheelNode & node) noexcept
+    {
+        g_FrameTimers.Schedule(node);
+    }
+
+    void WaitForFrameSignal(FrameSignalType signal, CoroWaitNode & waiter) noexcept
+    {
+        if (signal == FrameSignalType::NextFrame)
+        {
+            g_NextFrameSignal.Wait(waiter);
+        }
+        else
+        {
+            g_AfterPresentSignal.Wait(waiter);
+        }
+    }
+
+    void AdvanceFrameTimers() noexcept
+    {
+        g_FrameTimers.Advance(GetFrameTimerTick());
+    }
+
+    void SignalNextFrame() noexcept
+    {
+        g_NextFrameSignal.Signal();
+    }
+
+    void SignalAfterPresent() noexcept
+    {
+        g_AfterPresentSignal.Signal();
+    }
+
+    std::chrono::microseconds g_MainThreadWorkBudget = std::chrono::microseconds(4000);
+    std::chrono::steady_clock::time_point g_MainThreadFrameStart;
+    MainThreadFrameStats g_CurrentMainThreadFrame;
+    MainThreadFrameStats g_LastMainThreadFrame;
+
+    MainThreadFrameStats GetMainThreadFrameStats() noexcept
+    {
+        return g_LastMainThreadFrame;
+    }
+
+    void SetMainThreadWorkBudget(std::chrono::microseconds budget) noexcept
+    {
+        g_MainThreadWorkBudget = budget;
+    }
+
+    std::chrono::microseconds GetMainThreadWorkBudget() noexcept
+    {
+        return g_MainThreadWorkBudget;
+    }
+
+    void BeginMainThreadFrame() noexcept
+    {
+        g_MainThreadFrameStart = std::chrono::steady_clock::now();
+        g_CurrentMainThreadFrame = MainThreadFrameStats{ .m_FrameIndex = g_LastMainThreadFrame.m_FrameIndex + 1 };
+    }
+
+    void EndMainThreadFrame() noexcept
+    {
+        const auto busy_time = std::chrono::steady_clock::now() - g_MainThreadFrameStart;
+        g_CurrentMainThreadFrame.m_BusyTimeUs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(busy_time).count());
+
+        g_LastMainThreadFrame = g_CurrentMainThreadFrame;
+    }
+
+    void RunMainThreadWork() noexcept
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const int work_items_run = g_MainThreadQueue.TryExecuteWork(g_MainThreadWorkBudget);
+        const auto work_time = std::chrono::steady_clock::now() - start;
+
+        g_CurrentMainThreadFrame.m_WorkTimeUs += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(work_time).count());
+        g_CurrentMainThreadFrame.m_WorkItemsRun += static_cast<std::uint32_t>(work_items_run);
+        g_CurrentMainThreadFrame.m_WorkLeftOver = g_MainThreadQueue.HasWork();
+    }
+}
@@ -24,26 +24,48 @@ import :Types;
 import :Coroutine;
 import :FixedBlockAllocator;
 import :MultiProducerMultiConsumer;
+import :SpillQueue;
+import :WorkStealingDeque;
 import :JobTypes;
 
 namespace YT
 {
+    /// Snapshot of how often the job threads went idle and how they were woken back up
+    export struct JobManagerStats
+    {
+        std::uint64_t m_MonitorWaits = 0;       ///< Naps taken in umwait/mwaitx while waiting for work
+        std::uint64_t m_Parks = 0;              ///< Times a thread parked on its futex
+        std::uint64_t m_MonitorWakeups = 0;     ///< Wakeups sent to a thread napping in umwait/mwaitx
+        std::uint64_t m_FutexWakeups = 0;       ///< Wakeups sent to a parked thread through the futex
+        std::uint64_t m_IdleLanePromotions = 0; ///< Times the idle lane jumped ahead of higher lanes to avoid starving
+        std::uint64_t m_ExternalSpills = 0;     ///< External jobs that overflowed their lane's ring, summed over lanes
+        std::uint64_t m_ExternalHighWater = 0;  ///< Most external jobs spilled at once in any one lane
+    };
+
     // Thread-safe job system using C++20 coroutines for task-based parallelism
     class JobManager
     {
     public:
 
-        static constexpr int NumJobThreads = Threading::NumJobThreads;  ///< Number of worker threads (including main thread)
+        static constexpr std::size_t MaxQueuedJobsPerThread = 4096;     ///< Capacity of each thread's work-stealing deque, per priority
+        static constexpr int IdleLaneStarvationLimit = 32;              ///< Higher lane jobs a thread runs in a row before it checks the idle lane first
+
+        static constexpr int ExternalJobPollInterval = 6;               ///< Failed job polls between checks of the external queue
+        static constexpr int IdleSpinCount = 64;                        ///< Failed job polls before a thread starts waiting
+        static constexpr int IdleMonitorCount = 64;                     ///< umwait/mwaitx naps before a thread parks on the futex
+        static constexpr std::uint32_t IdleMonitorTimeout = 100000;     ///< Cycles per umwait/mwaitx nap
 
         static bool CreateJobManager() noexcept;
 
         /**
          * @brief Constructs a JobManager and starts worker threads.
          * 
-         * Initializes thread-local state and spawns NumThreads-1 worker threads.
+         * Initializes thread-local state and spawns num_threads-1 worker threads.
          * The main thread (thread 0) is used for root job execution and coordination.
+         *
+         * @param num_threads Number of job threads including the main thread
          */
-        JobManager();
+        explicit JobManager(int num_threads);
 
         /**
          * @brief Destroys the JobManager and joins all worker threads.
@@ -64,24 +86,102 @@ namespace YT
         /**
          * @brief Stops job execution by signaling worker threads to stop processing.
          * 
-         * Sets the running flag to false, causing worker threads to stop processing jobs.
+         * Sets the running flag to false and wakes any idle worker threads so they stop processing jobs.
          * Does not wait for in-progress jobs to complete.
          */
         void StopRunningJobs();
 
-        void PushJob(CoroBase & coro) noexcept;
+        /**
+         * @brief Queues a coroutine for execution on the job threads.
+         *
+         * Job and main threads push onto their own deque where idle job threads can steal it. Other threads,
+         * or a job thread whose deque is full, go through the shared external queue. If any job thread is
+         * idle, exactly one of them is woken to pick the job up.
+         *
+         * @param coro The coroutine to resume
+         * @param priority The lane to queue the coroutine in
+         */
+        void PushJob(CoroBase & coro, JobPriority priority) noexcept;
+
+        /// Queues a coroutine in the lane it was given with Coro::WithPriority (or inherited)
+        void PushJob(CoroBase & coro) noexcept
+        {
+            PushJob(coro, coro.GetPriority());
+        }
+
+        /// True between PrepareToRunJobs and StopRunningJobs, jobs are routed through the main thread queue otherwise
+        [[nodiscard]] bool IsRunning() const noexcept
+        {
+            return m_Running.load(std::memory_order_acquire);
+        }
+
+        /// Number of job threads (including main thread)
+        [[nodiscard]] int GetNumJobThreads() const noexcept
+        {
+            return m_NumJobThreads;
+        }
+
+        [[nodiscard]] JobManagerStats GetStats() const noexcept;
+
+        /**
+         * @brief Runs one pending job on the calling thread, for threads that would otherwise block waiting.
+         *
+         * Only job threads and the main thread take part, they run jobs from their own deque, by stealing, or from
+         * the external queues exactly like an idle job thread would. The main thread runs them as Job context.
+         *
+         * @return true if a job ran
+         */
+        bool TryRunPendingJob() noexcept;
 
     private:
 
         /**
-         * @brief Processes pending jobs for a specific thread.
+         * @brief Runs one pending job from the highest lane that has one.
+         *
+         * Each lane is checked in this thread's deque, then the other threads' deques, then the external queue.
+         * After IdleLaneStarvationLimit higher lane jobs in a row the idle lane gets checked first once.
          * 
          * @param thread_id The thread ID to process jobs for
          * @return true if a job was processed, false otherwise
          */
         bool ProcessJobList(int thread_id) noexcept;
 
-        void ProcessExternalJobs() noexcept;
+        bool TryGetJob(int thread_id, JobPriority priority, CoroBase *& out_coro) noexcept;
+
+        /**
+         * @brief Tries to steal the oldest job in a lane from another thread's deque.
+         *
+         * @param thread_id The thread ID doing the stealing
+         * @param priority The lane to steal from
+         * @param out_coro Receives the stolen job
+         * @return true if a job was stolen, false otherwise
+         */
+        bool TryStealJob(int thread_id, JobPriority priority, CoroBase *& out_coro) noexcept;
+
+        void PushExternalJob(CoroBase & coro, JobPriority priority) noexcept;
+
+        static void RunJob(CoroBase & coro, JobPriority priority) noexcept;
+
+        /// Runs everything in the external queues, returns true if anything ran. The main thread queue is left to the frame loop.
+        bool ProcessExternalJobs() noexcept;
+
+        [[nodiscard]] bool HasPendingJobs() const noexcept;
+
+        /**
+         * @brief Puts an idle worker thread to sleep until it's woken or times out.
+         *
+         * The first IdleMonitorCount waits nap in umwait/mwaitx on the thread's wake signal, after that the
+         * thread parks on the futex until PushJob or StopRunningJobs wakes it.
+         *
+         * @param thread_id The ID of the idle worker thread
+         * @param wait_count How many times in a row this thread has waited without finding work
+         */
+        void WaitForJobs(int thread_id, int wait_count) noexcept;
+
+        /// Wakes a single idle worker thread, if there are any, after a job was pushed
+        void WakeIdleThread() noexcept;
+
+        void WakeAllThreads() noexcept;
 
         /**
          * @brief Main loop for worker threads.
@@ -93,23 +193,46 @@ namespace YT
     private:
         static constexpr std::size_t CacheLineSize = 64;//std::hardware_destructive_interference_size;
 
-        /// Structure for storing a single job in a thread's queue padded to avoid false sharing
-        struct JobBlock
+        enum class IdleState : std::uint32_t
+        {
+            Active,     ///< Running or polling for jobs
+            Napping,    ///< Sleeping in umwait/mwaitx on m_WakeSignal
+            Parked,     ///< Sleeping on the m_WakeSignal futex
+        };
+
+        /// Per thread job storage, owned by the thread but open to stealing from every other job thread
+        struct alignas(CacheLineSize) JobThreadData
+        {
+            std::array<WorkStealingDeque<CoroBase *, MaxQueuedJobsPerThread>, NumJobPriorities> m_Jobs;   ///< One deque per priority lane
+            int m_HigherLaneJobsInARow = 0;         ///< Only touched by the owning thread
+
+            alignas(CacheLineSize) std::atomic<IdleState> m_IdleState = IdleState::Active;
+            std::atomic_uint32_t m_WakeSignal = 0;  ///< Bumped by whoever wakes the thread, monitored while napping
+        };
+
+        struct alignas(CacheLineSize) IdleStats
         {
-            std::atomic<CoroBase *> m_Coroutine = nullptr;
-            std::byte m_Pad[CacheLineSize - sizeof(m_Coroutine)];
+            std::atomic_uint64_t m_MonitorWaits = 0;
+            std::atomic_uint64_t m_Parks = 0;
+            std::atomic_uint64_t m_MonitorWakeups = 0;
+            std::atomic_uint64_t m_FutexWakeups = 0;
+            std::atomic_uint64_t m_IdleLanePromotions = 0;
         };
 
         std::atomic_bool m_Quit = false;                    ///< Flag to signal thread termination
         std::atomic_bool m_Running = false;                 ///< Flag indicating if jobs are being processed
 
-        std::counting_semaphore<NumJobThreads> m_RunningSemaphore{0};  ///< Semaphore for thread synchronization
+        Semaphore m_RunningSemaphore{0};                    ///< Semaphore for thread synchronization
 
+        int m_NumJobThreads = 1;                            ///< Number of worker threads (including main thread)
+        alignas(CacheLineSize) std::atomic_int m_NumIdleThreads = 0;  ///< Worker threads currently napping or parked
+        IdleStats m_IdleStats;
         std::vector<std::thread> m_Threads;                 ///< Worker thread handles
+        Vector<int> m_MainThreadAffinity;                   ///< Main thread CPU set to restore on destruction, empty if we left it alone
 
-        MultiProducerMultiConsumer<CoroBase*, 2048> m_ExternalJobs;
+        std::array<SpillQueue<CoroBase*, 2048>, NumJobPriorities> m_ExternalJobs;  ///< Jobs pushed from non-job threads, per lane
 
-        JobBlock m_Blocks[NumJobThreads][NumJobThreads];          ///< Job queues for each thread
+        UniquePtr<JobThreadData[]> m_ThreadData;            ///< Job deques for each thread (index 0 is the main thread)
     };
 
     /// Global JobManager instance
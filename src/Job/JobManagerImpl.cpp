@@ -4,6 +4,9 @@ module;
 //import_std
 
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <array>
 #include <vector>
@@ -19,11 +22,16 @@ import :Types;
 import :JobManager;
 import :Coroutine;
 import :WorkerThread;
+import :Wait;
+import :JobTrace;
+import :ThreadTopology;
+import :SpillQueue;
+import :DeterministicScheduler;
 
 namespace YT
 {
     thread_local int g_JobThreadID = -1;
-    thread_local int g_NextJobID = 0;
+    thread_local int g_NextStealVictim = 0;
 
     bool JobManager::CreateJobManager() noexcept
     {
@@ -34,7 +42,7 @@ namespace YT
 
         try
         {
-            g_JobManager = MakeUnique<JobManager>();
+            g_JobManager = MakeUnique<JobManager>(static_cast<int>(Threading::GetNumJobThreads()));
             return true;
         }
         catch (...)
@@ -43,11 +51,25 @@ namespace YT
         }
     }
 
-    JobManager::JobManager()
+    JobManager::JobManager(int num_threads)
+        : m_NumJobThreads{ num_threads }
+        , m_ThreadData{ std::make_unique<JobThreadData[]>(num_threads) }
     {
+        assert(m_NumJobThreads >= 1);
+
         g_JobThreadID = 0;
-        g_NextJobID = 0;
-        for (int i = 1; i < NumJobThreads; ++i)
+        g_NextStealVictim = 1 % m_NumJobThreads;
+
+        // The main thread runs jobs as thread 0 but floats over the pool's CPUs, it has plenty else to do.
+        // Put back whatever it had before once we're gone so a recreated manager starts from the same place.
+        Vector<int> main_thread_affinity = GetCurrentThreadAffinity();
+        if (ApplyPoolAffinity(ThreadPoolType::Job, 0))
+        {
+            m_MainThreadAffinity = std::move(main_thread_affinity);
+        }
+
+        m_Threads.reserve(m_NumJobThreads - 1);
+        for (int i = 1; i < m_NumJobThreads; ++i)
         {
             m_Threads.emplace_back([this, i]{ JobMain(i); });
         }
@@ -56,27 +78,63 @@ namespace YT
     JobManager::~JobManager() noexcept
     {
         m_Quit.store(true, std::memory_order_relaxed);
-        m_RunningSemaphore.release(NumJobThreads - 1);
+        m_Running.store(false, std::memory_order_seq_cst);
+        WakeAllThreads();
+
+        m_RunningSemaphore.release(m_NumJobThreads - 1);
         for (std::thread & thread : m_Threads)
         {
             thread.join();
         }
+
+        if (!m_MainThreadAffinity.empty())
+        {
+            SetCurrentThreadAffinity(m_MainThreadAffinity);
+        }
     }
 
     void JobManager::PrepareToRunJobs()
     {
         m_Running.store(true, std::memory_order_release);
-        m_RunningSemaphore.release(NumJobThreads - 1);
+        m_RunningSemaphore.release(m_NumJobThreads - 1);
     }
 
     void JobManager::StopRunningJobs()
     {
-        m_Running.store(false, std::memory_order_release);
+        m_Running.store(false, std::memory_order_seq_cst);
+        WakeAllThreads();
     }
 
-    void JobManager::PushJob(CoroBase & coro) noexcept
+    JobManagerStats JobManager::GetStats() const noexcept
     {
-        if constexpr (NumJobThreads == 1)
+        std::uint64_t external_spills = 0;
+        std::uint64_t external_high_water = 0;
+        for (const SpillQueue<CoroBase*, 2048> & lane : m_ExternalJobs)
+        {
+            const SpillQueueStats lane_stats = lane.GetStats();
+            external_spills += lane_stats.m_Spills;
+            external_high_water = std::max(external_high_water, lane_stats.m_HighWater);
+        }
+
+        return JobManagerStats
+        {
+            .m_MonitorWaits = m_IdleStats.m_MonitorWaits.load(std::memory_order_relaxed),
+            .m_Parks = m_IdleStats.m_Parks.load(std::memory_order_relaxed),
+            .m_MonitorWakeups = m_IdleStats.m_MonitorWakeups.load(std::memory_order_relaxed),
+            .m_FutexWakeups = m_IdleStats.m_FutexWakeups.load(std::memory_order_relaxed),
+            .m_IdleLanePromotions = m_IdleStats.m_IdleLanePromotions.load(std::memory_order_relaxed),
+            .m_ExternalSpills = external_spills,
+            .m_ExternalHighWater = external_high_water,
+        };
+    }
+
+    void JobManager::PushJob(CoroBase & coro, JobPriority priority) noexcept
+    {
+        if (g_DeterministicScheduler)
+        {
+            g_DeterministicScheduler->Push(ThreadContextType::Job, [coro = &coro] { coro->Resume(); });
+        }
+        else if (m_NumJobThreads == 1)
         {
             coro.Resume();
         }
@@ -89,22 +147,15 @@ namespace YT
                 {
                     assert(g_JobThreadID >= 0);
 
-                    JobBlock & block = m_Blocks[g_NextJobID][g_JobThreadID];
-
-                    if (CoroBase * existing_coro = block.m_Coroutine.exchange(&coro, std::memory_order_relaxed))
-                    {
-                        existing_coro->Resume();
-                    }
-
-                    g_NextJobID = (g_NextJobID + 1) % NumJobThreads;
-                }
-                else
-                {
-                    while (!m_ExternalJobs.TryEnqueue(&coro))
+                    if (m_ThreadData[g_JobThreadID].m_Jobs[static_cast<std::size_t>(priority)].Push(&coro))
                     {
-                        std::this_thread::yield();
+                        WakeIdleThread();
+                        return;
                     }
                 }
+
+                PushExternalJob(coro, priority);
+                WakeIdleThread();
             }
             else
             {
@@ -114,18 +165,134 @@ namespace YT
 
     }
 
+    bool JobManager::TryRunPendingJob() noexcept
+    {
+        if (g_JobThreadID < 0 || !m_Running.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        const ThreadContextType previous_context = GetCurrentThreadContext();
+        SetCurrentThreadContext(ThreadContextType::Job);
+
+        const bool ran = ProcessJobList(g_JobThreadID);
+
+        SetCurrentThreadContext(previous_context);
+        return ran;
+    }
+
+    void JobManager::PushExternalJob(CoroBase & coro, JobPriority priority) noexcept
+    {
+        m_ExternalJobs[static_cast<std::size_t>(priority)].Enqueue(&coro);
+    }
+
+    void JobManager::RunJob(CoroBase & coro, JobPriority priority) noexcept
+    {
+        // Jobs started from here without an explicit priority inherit this one
+        const JobPriority previous_priority = GetCurrentJobPriority();
+        SetCurrentJobPriority(priority);
+        {
+            const JobTraceWorkScope trace_scope(&coro, ThreadContextType::Job, static_cast<std::uint8_t>(priority));
+            coro.Resume();
+        }
+        SetCurrentJobPriority(previous_priority);
+    }
+
     bool JobManager::ProcessJobList(int thread_id) noexcept
     {
-        for (int i = 0; i < NumJobThreads; ++i)
+        JobThreadData & data = m_ThreadData[thread_id];
+        CoroBase * coro = nullptr;
+
+        if (data.m_HigherLaneJobsInARow >= IdleLaneStarvationLimit)
         {
-            JobBlock & block = m_Blocks[thread_id][i];
+            data.m_HigherLaneJobsInARow = 0;
+            if (TryGetJob(thread_id, JobPriority::Idle, coro))
+            {
+                m_IdleStats.m_IdleLanePromotions.fetch_add(1, std::memory_order_relaxed);
+                RunJob(*coro, JobPriority::Idle);
+                return true;
+            }
+        }
 
-            // First do a load to check if the handle exists
-            if (block.m_Coroutine.load(std::memory_order_relaxed))
+        for (std::size_t lane = 0; lane < NumJobPriorities; ++lane)
+        {
+            const JobPriority priority = static_cast<JobPriority>(lane);
+            if (TryGetJob(thread_id, priority, coro))
             {
-                if (CoroBase * handle = block.m_Coroutine.exchange(nullptr, std::memory_order_acq_rel))
+                data.m_HigherLaneJobsInARow = priority == JobPriority::Idle ? 0 : data.m_HigherLaneJobsInARow + 1;
+                RunJob(*coro, priority);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool JobManager::TryGetJob(int thread_id, JobPriority priority, CoroBase *& out_coro) noexcept
+    {
+        const std::size_t lane = static_cast<std::size_t>(priority);
+        return m_ThreadData[thread_id].m_Jobs[lane].Pop(out_coro) ||
+            TryStealJob(thread_id, priority, out_coro) ||
+            m_ExternalJobs[lane].TryDequeue(out_coro);
+    }
+
+    bool JobManager::TryStealJob(int thread_id, JobPriority priority, CoroBase *& out_coro) noexcept
+    {
+        const std::size_t lane = static_cast<std::size_t>(priority);
+
+        // Start from a rotating victim so thieves spread out instead of all hammering the same deque
+        const int first_victim = g_NextStealVictim;
+        g_NextStealVictim = (g_NextStealVictim + 1) % m_NumJobThreads;
+
+        for (int i = 0; i < m_NumJobThreads; ++i)
+        {
+            const int victim = (first_victim + i) % m_NumJobThreads;
+            if (victim == thread_id)
+            {
+                continue;
+            }
+
+            auto & jobs = m_ThreadData[victim].m_Jobs[lane];
+            if (!jobs.Empty() && jobs.Steal(out_coro))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool JobManager::ProcessExternalJobs() noexcept
+    {
+        bool processed = false;
+
+        for (std::size_t lane = 0; lane < NumJobPriorities; ++lane)
+        {
+            CoroBase * coro = nullptr;
+            while (m_ExternalJobs[lane].TryDequeue(coro))
+            {
+                RunJob(*coro, static_cast<JobPriority>(lane));
+                processed = true;
+            }
+        }
+
+        // g_MainThreadQueue is left to the frame loop, RunMainThreadWork is its only budgeted consumer
+        return processed;
+    }
+
+    bool JobManager::HasPendingJobs() const noexcept
+    {
+        for (std::size_t lane = 0; lane < NumJobPriorities; ++lane)
+        {
+            if (!m_ExternalJobs[lane].Empty())
+            {
+                return true;
+            }
+
+            for (int i = 0; i < m_NumJobThreads; ++i)
+            {
+                if (!m_ThreadData[i].m_Jobs[lane].Empty())
                 {
-                    handle->Resume();
                     return true;
                 }
             }
@@ -134,24 +301,110 @@ namespace YT
         return false;
     }
 
-    void JobManager::ProcessExternalJobs() noexcept
+    void JobManager::WaitForJobs(int thread_id, int wait_count) noexcept
     {
-        CoroBase * coro = nullptr;
-        while (m_ExternalJobs.TryDequeue(coro))
+        JobThreadData & data = m_ThreadData[thread_id];
+
+        const bool park = wait_count > IdleMonitorCount;
+        const std::uint32_t wake_signal = data.m_WakeSignal.load(std::memory_order_acquire);
+
+        // Publish that we're idle before the final check for work. Pairs with the fence in WakeIdleThread,
+        // either the pusher sees us idle and wakes us or we see its job here.
+        data.m_IdleState.store(park ? IdleState::Parked : IdleState::Napping, std::memory_order_seq_cst);
+        m_NumIdleThreads.fetch_add(1, std::memory_order_seq_cst);
+
+        if (m_Running.load(std::memory_order_seq_cst) && !HasPendingJobs())
         {
-            coro->Resume();
+            if (park)
+            {
+                m_IdleStats.m_Parks.fetch_add(1, std::memory_order_relaxed);
+                data.m_WakeSignal.wait(wake_signal, std::memory_order_acquire);
+            }
+            else
+            {
+                m_IdleStats.m_MonitorWaits.fetch_add(1, std::memory_order_relaxed);
+
+                // One nap per call, WaitForJobs counts them towards IdleMonitorCount. Without umwait/mwaitx this
+                // yields instead of burning a pause and coming straight back.
+                constexpr AtomicWaitPolicy NapWaitPolicy =
+                {
+                    .m_SpinCount = 0,
+                    .m_MonitorCount = 1,
+                    .m_MonitorTimeout = IdleMonitorTimeout,
+                    .m_Park = false,
+                };
+                AtomicWait(data.m_WakeSignal, wake_signal, NapWaitPolicy);
+            }
         }
 
-        g_MainThreadQueue.TryExecuteWork();
+        m_NumIdleThreads.fetch_sub(1, std::memory_order_relaxed);
+        data.m_IdleState.store(IdleState::Active, std::memory_order_relaxed);
+    }
+
+    void JobManager::WakeIdleThread() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_NumIdleThreads.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+
+        // Start next to ourselves so concurrent pushers tend to claim different threads
+        const int first_thread = std::max(g_JobThreadID, 0);
+        for (int i = 1; i <= m_NumJobThreads; ++i)
+        {
+            const int thread_id = (first_thread + i) % m_NumJobThreads;
+            if (thread_id == 0 || thread_id == g_JobThreadID)
+            {
+                // The main thread never idles in JobMain
+                continue;
+            }
+
+            JobThreadData & data = m_ThreadData[thread_id];
+
+            IdleState state = data.m_IdleState.load(std::memory_order_relaxed);
+            if (state == IdleState::Active ||
+                !data.m_IdleState.compare_exchange_strong(state, IdleState::Active, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                continue;
+            }
+
+            data.m_WakeSignal.fetch_add(1, std::memory_order_release);
+            if (state == IdleState::Parked)
+            {
+                data.m_WakeSignal.notify_one();
+                m_IdleStats.m_FutexWakeups.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                // Writing the monitored line is enough to end the nap
+                m_IdleStats.m_MonitorWakeups.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return;
+        }
+    }
+
+    void JobManager::WakeAllThreads() noexcept
+    {
+        for (int thread_id = 1; thread_id < m_NumJobThreads; ++thread_id)
+        {
+            JobThreadData & data = m_ThreadData[thread_id];
+            data.m_IdleState.store(IdleState::Active, std::memory_order_relaxed);
+            data.m_WakeSignal.fetch_add(1, std::memory_order_release);
+            data.m_WakeSignal.notify_one();
+        }
     }
 
     void JobManager::JobMain(int thread_id) noexcept
     {
         g_JobThreadID = thread_id;
-        g_NextJobID = (thread_id + 1) % NumJobThreads;
+        g_NextStealVictim = (thread_id + 1) % m_NumJobThreads;
 
         MakeThreadLocalCoroutineAllocator();
         SetCurrentThreadContext(ThreadContextType::Job);
+        SetJobTraceThreadName("Job", thread_id);
+        ApplyThreadAffinity(ThreadPoolType::Job, static_cast<std::size_t>(thread_id));
 
         while (!m_Quit.load(std::memory_order_relaxed))
         {
@@ -161,16 +414,29 @@ namespace YT
 
             while (m_Running.load(std::memory_order_acquire))
             {
-                if (!ProcessJobList(thread_id))
+                if (ProcessJobList(thread_id))
                 {
-                    idle_count++;
+                    idle_count = 0;
+                    continue;
+                }
+
+                // Saturate so a long parked stretch can't overflow the counter
+                idle_count = std::min(idle_count + 1, IdleSpinCount + IdleMonitorCount + 1);
 
-                    if (idle_count  > 5)
+                // Once we're past spinning, drain the external queue before every wait
+                if (idle_count % ExternalJobPollInterval == 0 || idle_count > IdleSpinCount)
+                {
+                    if (ProcessExternalJobs())
                     {
-                        ProcessExternalJobs();
                         idle_count = 0;
+                        continue;
                     }
                 }
+
+                if (idle_count > IdleSpinCount)
+                {
+                    WaitForJobs(thread_id, idle_count - IdleSpinCount);
+                }
             }
         }
     }
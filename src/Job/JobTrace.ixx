@@ -0,0 +1,102 @@
+module;
+
+//import_std
+
+#include <cstddef>
+#include <cstdint>
+
+export module YT:JobTrace;
+
+import :Types;
+import :JobTypes;
+
+namespace YT
+{
+    /// Trace points only exist when the build defines YT_JOB_TRACE (the YT_JOB_TRACE CMake option)
+#ifdef YT_JOB_TRACE
+    export constexpr bool JobTraceEnabled = true;
+#else
+    export constexpr bool JobTraceEnabled = false;
+#endif
+
+    export enum class JobTraceEventType : std::uint8_t
+    {
+        Schedule,       ///< A coroutine was handed to the thread context it runs on
+        ResumeBegin,
+        ResumeEnd,
+        Complete,       ///< A coroutine reached its final suspend
+        WorkBegin,      ///< A worker thread picked up a job or work item
+        WorkEnd,
+    };
+
+    void RecordJobTraceEvent(JobTraceEventType type, const void * object, ThreadContextType context, std::uint8_t detail) noexcept;
+    void RecordJobTraceThreadName(const char * name, int index) noexcept;
+
+    /**
+     * @brief Records a trace event into the calling thread's ring buffer.
+     *
+     * @param type What happened
+     * @param object The coroutine or work item it happened to, used to tie events together
+     * @param context The thread context the coroutine or work item belongs to
+     * @param detail Extra event data, the JobPriority for job events
+     */
+    export inline void TraceJobEvent(JobTraceEventType type, const void * object, ThreadContextType context, std::uint8_t detail = 0) noexcept
+    {
+        if constexpr (JobTraceEnabled)
+        {
+            RecordJobTraceEvent(type, object, context, detail);
+        }
+    }
+
+    /// Names the calling thread in the trace, index is appended when it isn't negative
+    export inline void SetJobTraceThreadName(const char * name, int index = -1) noexcept
+    {
+        if constexpr (JobTraceEnabled)
+        {
+            RecordJobTraceThreadName(name, index);
+        }
+    }
+
+    /// Records a WorkBegin/WorkEnd pair around a scope
+    export class JobTraceWorkScope final
+    {
+    public:
+        JobTraceWorkScope(const void * object, ThreadContextType context, std::uint8_t detail = 0) noexcept
+        {
+            if constexpr (JobTraceEnabled)
+            {
+                m_Object = object;
+                m_Context = context;
+                m_Detail = detail;
+                RecordJobTraceEvent(JobTraceEventType::WorkBegin, object, context, detail);
+            }
+        }
+
+        JobTraceWorkScope(const JobTraceWorkScope &) = delete;
+        JobTraceWorkScope & operator=(const JobTraceWorkScope &) = delete;
+
+        ~JobTraceWorkScope() noexcept
+        {
+            if constexpr (JobTraceEnabled)
+            {
+                RecordJobTraceEvent(JobTraceEventType::WorkEnd, m_Object, m_Context, m_Detail);
+            }
+        }
+
+    private:
+        const void * m_Object = nullptr;
+        ThreadContextType m_Context = ThreadContextType::Unknown;
+        std::uint8_t m_Detail = 0;
+    };
+
+    /**
+     * @brief Drains every thread's trace buffer into a Chrome trace JSON file.
+     *
+     * The file loads in chrome://tracing and in the Perfetto UI. Events are consumed, so each call writes what
+     * was recorded since the previous one.
+     *
+     * @param file_name The file to write
+     * @return false if tracing is compiled out or the file couldn't be written
+     */
+    export bool WriteJobTrace(const StringView & file_name) noexcept;
+}
@@ -0,0 +1,210 @@
+module;
+
+//import_std
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+module YT:JobTraceImpl;
+
+import :Types;
+import :JobTypes;
+import :JobTrace;
+import :SingleProducerSingleConsumer;
+
+namespace YT
+{
+#ifdef YT_JOB_TRACE
+    struct JobTraceEvent
+    {
+        std::uint64_t m_TimeNs = 0;
+        const void * m_Object = nullptr;
+        JobTraceEventType m_Type = JobTraceEventType::Schedule;
+        ThreadContextType m_Context = ThreadContextType::Unknown;
+        std::uint8_t m_Detail = 0;
+    };
+
+    /// One per thread that has recorded an event, written only by that thread and drained by WriteJobTrace
+    struct JobTraceThreadBuffer
+    {
+        static constexpr std::size_t Capacity = 16384;
+
+        int m_ThreadIndex = 0;
+        String m_Name;
+        std::atomic_uint64_t m_Dropped = 0;     ///< Events lost because the buffer was full
+        SingleProducerSingleConsumer<JobTraceEvent, Capacity> m_Events;
+    };
+
+    Mutex g_JobTraceMutex;
+    Vector<UniquePtr<JobTraceThreadBuffer>> g_JobTraceBuffers;  ///< Never shrinks, so a buffer outlives its thread
+    const std::chrono::steady_clock::time_point g_JobTraceStartTime = std::chrono::steady_clock::now();
+
+    thread_local JobTraceThreadBuffer * g_JobTraceThreadBuffer = nullptr;
+
+    JobTraceThreadBuffer & GetJobTraceThreadBuffer() noexcept
+    {
+        if (!g_JobTraceThreadBuffer)
+        {
+            const std::scoped_lock lock(g_JobTraceMutex);
+
+            UniquePtr<JobTraceThreadBuffer> & buffer = g_JobTraceBuffers.emplace_back(MakeUnique<JobTraceThreadBuffer>());
+            buffer->m_ThreadIndex = static_cast<int>(g_JobTraceBuffers.size());
+            buffer->m_Name = Format("Thread {}", buffer->m_ThreadIndex);
+            g_JobTraceThreadBuffer = buffer.get();
+        }
+
+        return *g_JobTraceThreadBuffer;
+    }
+
+    void RecordJobTraceEvent(JobTraceEventType type, const void * object, ThreadContextType context, std::uint8_t detail) noexcept
+    {
+        JobTraceThreadBuffer & buffer = GetJobTraceThreadBuffer();
+
+        const auto elapsed = std::chrono::steady_clock::now() - g_JobTraceStartTime;
+        const JobTraceEvent event
+        {
+            .m_TimeNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            .m_Object = object,
+            .m_Type = type,
+            .m_Context = context,
+            .m_Detail = detail,
+        };
+
+        if (!buffer.m_Events.TryEnqueue(event))
+        {
+            buffer.m_Dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void RecordJobTraceThreadName(const char * name, int index) noexcept
+    {
+        JobTraceThreadBuffer & buffer = GetJobTraceThreadBuffer();
+
+        const std::scoped_lock lock(g_JobTraceMutex);
+        buffer.m_Name = index >= 0 ? Format("{} {}", name, index) : String(name);
+    }
+
+    const char * GetJobTraceContextName(ThreadContextType context) noexcept
+    {
+        switch (context)
+        {
+            case ThreadContextType::AnyThread: return "AnyThread";
+            case ThreadContextType::Main: return "Main";
+            case ThreadContextType::Job: return "Job";
+            case ThreadContextType::Background: return "Background";
+            case ThreadContextType::FileMapper: return "FileMapper";
+            case ThreadContextType::FreeType: return "FreeType";
+            default: return "Unknown";
+        }
+    }
+
+    const char * GetJobTracePriorityName(std::uint8_t priority) noexcept
+    {
+        switch (static_cast<JobPriority>(priority))
+        {
+            case JobPriority::FrameCritical: return "FrameCritical";
+            case JobPriority::Normal: return "Normal";
+            case JobPriority::Idle: return "Idle";
+            default: return "Unknown";
+        }
+    }
+
+    /// Writes text as the contents of a JSON string, thread names can hold anything
+    void WriteJobTraceJsonString(std::FILE * file, const StringView & text) noexcept
+    {
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                std::fputc('\\', file);
+                std::fputc(c, file);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                std::fprintf(file, "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+            }
+            else
+            {
+                std::fputc(c, file);
+            }
+        }
+    }
+
+    void WriteJobTraceEvent(std::FILE * file, int thread_index, const JobTraceEvent & event) noexcept
+    {
+        const double ts = static_cast<double>(event.m_TimeNs) / 1000.0;
+        const char * context = GetJobTraceContextName(event.m_Context);
+
+        const char * name = "";
+        const char * phase = "i";
+        switch (event.m_Type)
+        {
+            case JobTraceEventType::Schedule: name = "Schedule"; phase = "i"; break;
+            case JobTraceEventType::ResumeBegin: name = "Resume"; phase = "B"; break;
+            case JobTraceEventType::ResumeEnd: name = "Resume"; phase = "E"; break;
+            case JobTraceEventType::Complete: name = "Complete"; phase = "i"; break;
+            case JobTraceEventType::WorkBegin: name = context; phase = "B"; break;
+            case JobTraceEventType::WorkEnd: name = context; phase = "E"; break;
+        }
+
+        std::fprintf(file,
+            ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%d%s"
+            "\"args\":{\"object\":\"%p\",\"context\":\"%s\"",
+            name, context, phase, ts, thread_index, phase[0] == 'i' ? ",\"s\":\"t\"," : ",",
+            event.m_Object, context);
+
+        // Only job work carries a priority, everything else leaves the detail at 0
+        const bool is_work = event.m_Type == JobTraceEventType::WorkBegin || event.m_Type == JobTraceEventType::WorkEnd;
+        if (is_work && event.m_Context == ThreadContextType::Job)
+        {
+            std::fprintf(file, ",\"priority\":\"%s\"", GetJobTracePriorityName(event.m_Detail));
+        }
+
+        std::fputs("}}", file);
+    }
+
+    bool WriteJobTrace(const StringView & file_name) noexcept
+    {
+        const String file_name_str(file_name);
+        std::FILE * file = std::fopen(file_name_str.c_str(), "w");
+        if (!file)
+        {
+            return false;
+        }
+
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"YT\"}}", file);
+
+        const std::scoped_lock lock(g_JobTraceMutex);
+        for (const UniquePtr<JobTraceThreadBuffer> & buffer : g_JobTraceBuffers)
+        {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+                buffer->m_ThreadIndex);
+            WriteJobTraceJsonString(file, buffer->m_Name);
+            std::fprintf(file, "\",\"dropped_events\":%llu}}",
+                static_cast<unsigned long long>(buffer->m_Dropped.load(std::memory_order_relaxed)));
+
+            JobTraceEvent event;
+            while (buffer->m_Events.TryDequeue(event))
+            {
+                WriteJobTraceEvent(file, buffer->m_ThreadIndex, event);
+            }
+        }
+
+        std::fputs("\n]}\n", file);
+        return std::fclose(file) == 0;
+    }
+#else
+    // Compiled out, the inline trace points in JobTrace.ixx never call into here
+    bool WriteJobTrace(const StringView &) noexcept
+    {
+        return false;
+    }
+#endif
+}
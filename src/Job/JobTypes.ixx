@@ -9,6 +9,7 @@ module;
 export module YT:JobTypes;
 
 import :Types;
+import :InplaceFunction;
 
 namespace YT
 {
@@ -23,8 +24,23 @@ namespace YT
         FreeType,
     };
 
+    /// Scheduling lanes for job threads, higher lanes are always drained first
+    export enum class JobPriority : std::uint8_t
+    {
+        FrameCritical,  ///< Work the current frame is waiting on
+        Normal,
+        Idle,           ///< Work that can wait, guaranteed a slot now and then so it never starves
+
+        Count,
+    };
+
+    export constexpr std::size_t NumJobPriorities = static_cast<std::size_t>(JobPriority::Count);
+
     export class CoroBase;
 
+    /// Unit of work in the worker queues, sized for a captured pointer or two so queueing never allocates
+    export using WorkFunction = InplaceFunction<void(), 16>;
+
     export class JobManager;
 
     export template <typename ReturnType>
@@ -33,11 +49,18 @@ namespace YT
 
     static constexpr std::size_t CacheLineSize = 64;
 
+    export struct JobCompletionTrackingInfo;
+
+    /// Replaces the default completion handling of a tracked job, called once the job has fully suspended
+    using JobCompleteCallback = void (*)(JobCompletionTrackingInfo & counters, CoroBase & coro) noexcept;
+
+    /// Completion counter shared by a group of jobs and whoever waits on them
     export struct JobCompletionTrackingInfo
     {
-        std::size_t m_LocalCount = 0;
-        std::atomic_size_t m_RemoteCount = 0;
-        std::byte m_Pad[CacheLineSize - sizeof(m_LocalCount) - sizeof(m_RemoteCount)] = {};
+        std::atomic_size_t m_Outstanding = 1;   ///< Running jobs, plus one held by the group itself until a coroutine awaits it
+        CoroBase * m_Waiter = nullptr;          ///< Resumed by the job that drops m_Outstanding to zero
+        JobCompleteCallback m_OnJobComplete = nullptr;
+        std::byte m_Pad[CacheLineSize - sizeof(m_Outstanding) - sizeof(m_Waiter) - sizeof(m_OnJobComplete)] = {};
     };
 
 }
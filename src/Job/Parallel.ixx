@@ -0,0 +1,272 @@
+module;
+
+//import_std
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+export module YT:Parallel;
+
+import :Types;
+import :JobTypes;
+import :Coroutine;
+import :JobManager;
+
+namespace YT
+{
+    /**
+     * @brief Hands out chunks of [begin, end) to the threads taking part in a ParallelFor/ParallelReduce.
+     *
+     * Chunks are sized guided-style: each claim takes a share of what's left, so early claims are big and cheap
+     * while the tail is split finely enough to keep every thread busy. A chunk is never smaller than the grain.
+     */
+    class ParallelRange final
+    {
+    public:
+        ParallelRange(std::size_t begin, std::size_t end, std::size_t grain, std::size_t num_participants) noexcept
+            : m_End(end)
+            , m_Grain(grain)
+            , m_NumParticipants(num_participants)
+            , m_Next(begin)
+        {
+        }
+
+        [[nodiscard]] bool Claim(std::size_t & out_begin, std::size_t & out_end) noexcept
+        {
+            std::size_t begin = m_Next.load(std::memory_order_relaxed);
+            while (begin < m_End)
+            {
+                const std::size_t remaining = m_End - begin;
+                const std::size_t chunk = std::min(remaining, std::max(m_Grain, remaining / (m_NumParticipants * 2)));
+
+                if (m_Next.compare_exchange_weak(begin, begin + chunk, std::memory_order_relaxed))
+                {
+                    out_begin = begin;
+                    out_end = begin + chunk;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        const std::size_t m_End;
+        const std::size_t m_Grain;
+        const std::size_t m_NumParticipants;
+
+        alignas(64) std::atomic_size_t m_Next;  ///< Kept off the line with the read-only fields above
+    };
+
+    /// Number of threads that can work on a parallel loop right now, 1 if the job threads aren't running
+    [[nodiscard]] inline std::size_t GetParallelism() noexcept
+    {
+        if (!g_JobManager || !g_JobManager->IsRunning())
+        {
+            return 1;
+        }
+
+        return static_cast<std::size_t>(g_JobManager->GetNumJobThreads());
+    }
+
+    /// A grain of 0 picks one that gives every thread around 16 chunks once the guided chunks have shrunk
+    [[nodiscard]] inline std::size_t ResolveGrain(std::size_t count, std::size_t grain, std::size_t parallelism) noexcept
+    {
+        if (grain != 0)
+        {
+            return grain;
+        }
+
+        return std::max<std::size_t>(1, count / (parallelism * 16));
+    }
+
+    template <typename Fn>
+    void InvokeParallelRange(Fn & fn, std::size_t begin, std::size_t end)
+    {
+        if constexpr (std::invocable<Fn &, std::size_t, std::size_t>)
+        {
+            fn(begin, end);
+        }
+        else
+        {
+            for (std::size_t index = begin; index < end; ++index)
+            {
+                fn(index);
+            }
+        }
+    }
+
+    template <typename Body>
+    JobCoro<void> ParallelWorker(Body & body, std::size_t participant)
+    {
+        body(participant);
+        co_return;
+    }
+
+    /// Runs body(participant) on num_participants threads, the calling thread being participant 0
+    template <typename Body>
+    void RunParallel(std::size_t num_participants, Body & body)
+    {
+        CoroBundle<void> workers;
+        workers.Reserve(num_participants - 1);
+
+        for (std::size_t participant = 1; participant < num_participants; ++participant)
+        {
+            workers.PushJob(ParallelWorker(body, participant));
+        }
+
+        body(0);
+        workers.WaitForCompletion();
+    }
+
+    /**
+     * @brief Runs fn over [begin, end) on the job threads, the calling thread included.
+     *
+     * fn is either called per index, fn(index), or per chunk, fn(chunk_begin, chunk_end). Runs inline when the
+     * range fits in a single grain or the job threads aren't running.
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Smallest chunk handed to a thread, 0 to pick one from the range size
+     * @param fn The loop body
+     */
+    export template <typename Fn>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn && fn)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        const std::size_t count = end - begin;
+        const std::size_t parallelism = GetParallelism();
+        grain = ResolveGrain(count, grain, parallelism);
+
+        const std::size_t num_participants = std::min(parallelism, (count + grain - 1) / grain);
+        if (num_participants <= 1)
+        {
+            InvokeParallelRange(fn, begin, end);
+            return;
+        }
+
+        ParallelRange range(begin, end, grain, num_participants);
+
+        auto body = [&range, &fn](std::size_t)
+        {
+            std::size_t chunk_begin;
+            std::size_t chunk_end;
+            while (range.Claim(chunk_begin, chunk_end))
+            {
+                InvokeParallelRange(fn, chunk_begin, chunk_end);
+            }
+        };
+
+        RunParallel(num_participants, body);
+    }
+
+    /// ParallelFor over [0, count)
+    export template <typename Fn>
+    void ParallelFor(std::size_t count, std::size_t grain, Fn && fn)
+    {
+        ParallelFor(0, count, grain, std::forward<Fn>(fn));
+    }
+
+    /// ParallelFor calling fn(element) for every element of items
+    export template <typename T, typename Fn>
+    void ParallelFor(Span<T> items, std::size_t grain, Fn && fn)
+    {
+        ParallelFor(0, items.size(), grain, [&items, &fn](std::size_t index)
+        {
+            fn(items[index]);
+        });
+    }
+
+    /**
+     * @brief Reduces [begin, end) on the job threads, the calling thread included.
+     *
+     * Every thread folds the chunks it claims into its own partial result starting from identity, and the partials
+     * are combined with reduce at the end. fn is either called per index, fn(index) -> T, with the results combined
+     * using reduce, or per chunk, fn(chunk_begin, chunk_end, T accumulated) -> T. Chunks are claimed dynamically so
+     * reduce must be associative and commutative.
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Smallest chunk handed to a thread, 0 to pick one from the range size
+     * @param identity Starting value of every partial result
+     * @param fn Maps an index or folds a chunk
+     * @param reduce Combines two partial results
+     * @return The combined result, identity for an empty range
+     */
+    export template <typename T, typename Fn, typename ReduceFn>
+    [[nodiscard]] T ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, Fn && fn, ReduceFn && reduce)
+    {
+        if (begin >= end)
+        {
+            return identity;
+        }
+
+        const std::size_t count = end - begin;
+        const std::size_t parallelism = GetParallelism();
+        grain = ResolveGrain(count, grain, parallelism);
+
+        const std::size_t num_participants = std::max<std::size_t>(1, std::min(parallelism, (count + grain - 1) / grain));
+
+        struct alignas(64) Partial
+        {
+            T m_Value;
+        };
+
+        Vector<Partial> partials(num_participants, Partial{ identity });
+        ParallelRange range(begin, end, grain, num_participants);
+
+        auto body = [&range, &partials, &fn, &reduce](std::size_t participant)
+        {
+            T & accumulated = partials[participant].m_Value;
+
+            std::size_t chunk_begin;
+            std::size_t chunk_end;
+            while (range.Claim(chunk_begin, chunk_end))
+            {
+                if constexpr (std::invocable<Fn &, std::size_t, std::size_t, T>)
+                {
+                    accumulated = fn(chunk_begin, chunk_end, std::move(accumulated));
+                }
+                else
+                {
+                    for (std::size_t index = chunk_begin; index < chunk_end; ++index)
+                    {
+                        accumulated = reduce(std::move(accumulated), fn(index));
+                    }
+                }
+            }
+        };
+
+        if (num_participants == 1)
+        {
+            body(0);
+        }
+        else
+        {
+            RunParallel(num_participants, body);
+        }
+
+        T result = std::move(partials[0].m_Value);
+        for (std::size_t participant = 1; participant < num_participants; ++participant)
+        {
+            result = reduce(std::move(result), std::move(partials[participant].m_Value));
+        }
+
+        return result;
+    }
+
+    /// ParallelReduce over [0, count)
+    export template <typename T, typename Fn, typename ReduceFn>
+    [[nodiscard]] T ParallelReduce(std::size_t count, std::size_t grain, T identity, Fn && fn, ReduceFn && reduce)
+    {
+        return ParallelReduce(0, count, grain, std::move(identity), std::forward<Fn>(fn), std::forward<ReduceFn>(reduce));
+    }
+}
@@ -0,0 +1,128 @@
+module;
+
+//import_std
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+export module YT:TaskGraph;
+
+import :Types;
+import :JobTypes;
+import :Coroutine;
+
+namespace YT
+{
+    /**
+     * @brief A dependency graph of jobs that is built once and then submitted again and again.
+     *
+     * Every node owns a long-lived coroutine that loops forever, so submitting only resets the dependency counters
+     * and pushes the ready nodes' coroutines to the JobManager, nothing is allocated per submit. Nodes either call a
+     * function or co_await a JobCoro made by a factory (the JobCoro itself is of course allocated on every run).
+     *
+     * @note The graph must not be destroyed or modified while a submit is in flight.
+     */
+    export class TaskGraph final
+    {
+    public:
+        using NodeId = std::uint32_t;
+
+        TaskGraph() noexcept = default;
+        TaskGraph(const TaskGraph &) = delete;
+        TaskGraph(TaskGraph &&) = delete;
+        TaskGraph & operator=(const TaskGraph &) = delete;
+        TaskGraph & operator=(TaskGraph &&) = delete;
+
+        ~TaskGraph() noexcept;
+
+        /**
+         * @brief Adds a node that calls a function on a job thread.
+         *
+         * @param function Called every time the graph is submitted, once all the node's dependencies have run
+         * @param priority The job lane the node runs in
+         * @return The node's ID for AddDependency
+         */
+        NodeId AddNode(Function<void()> && function, JobPriority priority = JobPriority::Normal);
+
+        /**
+         * @brief Adds a node that makes a JobCoro and awaits it, the node is done once the coroutine returns.
+         *
+         * @param coro_factory Called every time the graph is submitted, once all the node's dependencies have run
+         * @param priority The job lane the node runs in
+         * @return The node's ID for AddDependency
+         */
+        NodeId AddCoroNode(Function<JobCoro<void>()> && coro_factory, JobPriority priority = JobPriority::Normal);
+
+        /// Makes after wait for before to finish on every submit
+        void AddDependency(NodeId before, NodeId after);
+
+        /**
+         * @brief Starts a run of the whole graph.
+         *
+         * The first submit after the graph changes checks it for dependency cycles. A graph with a cycle could never
+         * complete, so it asserts and, with asserts off, runs nothing.
+         *
+         * @pre The previous submit has completed
+         */
+        void Submit() noexcept;
+
+        [[nodiscard]] bool IsComplete() const noexcept
+        {
+            return m_RemainingNodes.load(std::memory_order_acquire) == 0;
+        }
+
+        /// Blocks until every node of the last submit has run. Callable from any thread, it helps with pending jobs (and
+        /// main thread work on the main thread) and otherwise waits on the remaining node count with a bounded AtomicWait
+        void WaitForCompletion() const noexcept;
+
+    private:
+        struct Node;
+
+        /// Suspends a node's coroutine and only then reports it complete, so the next submit can't resume it early
+        struct NodeCompleteAwaiter
+        {
+            TaskGraph & m_Graph;
+            Node & m_Node;
+
+            static bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) noexcept { m_Graph.OnNodeComplete(m_Node); }
+            static void await_resume() noexcept {}
+        };
+
+        struct Node
+        {
+            Node(TaskGraph & graph, JobPriority priority) noexcept
+                : m_Priority(priority)
+                , m_Runner(graph.RunNode(*this))
+            {
+            }
+
+            Function<void()> m_Function;
+            Function<JobCoro<void>()> m_CoroFactory;
+            Vector<NodeId> m_Successors;
+            std::uint32_t m_NumDependencies = 0;
+            JobPriority m_Priority = JobPriority::Normal;
+
+            alignas(64) std::atomic_uint32_t m_PendingDependencies = 0;   ///< Reset to m_NumDependencies on every submit
+
+            JobCoro<void> m_Runner;
+        };
+
+        JobCoro<void> RunNode(Node & node);
+
+        void OnNodeComplete(Node & node) noexcept;
+        void PushNode(Node & node) noexcept;
+
+        /// Kahn's algorithm over the dependency counts, true if every node can be reached from the roots
+        [[nodiscard]] bool IsAcyclic() const noexcept;
+
+    private:
+        Vector<UniquePtr<Node>> m_Nodes;
+        bool m_Validated = true;    ///< Cleared whenever the graph changes, set once Submit has checked it for cycles
+        alignas(64) std::atomic_uint32_t m_RemainingNodes = 0;
+    };
+}
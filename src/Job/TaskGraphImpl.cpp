@@ -0,0 +1,200 @@
+module;
+
+//import_std
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+
+module YT:TaskGraphImpl;
+
+import :Types;
+import :JobTypes;
+import :Coroutine;
+import :JobManager;
+import :TaskGraph;
+import :Wait;
+
+namespace YT
+{
+    TaskGraph::~TaskGraph() noexcept
+    {
+        // The node coroutines are all parked on their co_await and get destroyed with the nodes
+        assert(IsComplete() && "TaskGraph destroyed while a submit is in flight");
+    }
+
+    TaskGraph::NodeId TaskGraph::AddNode(Function<void()> && function, JobPriority priority)
+    {
+        assert(IsComplete());
+
+        UniquePtr<Node> & node = m_Nodes.emplace_back(MakeUnique<Node>(*this, priority));
+        node->m_Function = std::move(function);
+        m_Validated = false;
+        return static_cast<NodeId>(m_Nodes.size() - 1);
+    }
+
+    TaskGraph::NodeId TaskGraph::AddCoroNode(Function<JobCoro<void>()> && coro_factory, JobPriority priority)
+    {
+        assert(IsComplete());
+
+        UniquePtr<Node> & node = m_Nodes.emplace_back(MakeUnique<Node>(*this, priority));
+        node->m_CoroFactory = std::move(coro_factory);
+        m_Validated = false;
+        return static_cast<NodeId>(m_Nodes.size() - 1);
+    }
+
+    void TaskGraph::AddDependency(NodeId before, NodeId after)
+    {
+        assert(IsComplete());
+        assert(before < m_Nodes.size() && after < m_Nodes.size() && before != after);
+
+        m_Nodes[before]->m_Successors.push_back(after);
+        m_Nodes[after]->m_NumDependencies++;
+        m_Validated = false;
+    }
+
+    void TaskGraph::Submit() noexcept
+    {
+        assert(IsComplete() && "TaskGraph submitted again before the previous submit completed");
+
+        if (m_Nodes.empty())
+        {
+            return;
+        }
+
+        if (!m_Validated)
+        {
+            // Nodes in a cycle would never be pushed and m_RemainingNodes would never reach 0
+            if (!IsAcyclic())
+            {
+                assert(false && "TaskGraph has a dependency cycle");
+                return;
+            }
+
+            m_Validated = true;
+        }
+
+        // Every counter has to be reset before the first root starts decrementing them
+        for (UniquePtr<Node> & node : m_Nodes)
+        {
+            node->m_PendingDependencies.store(node->m_NumDependencies, std::memory_order_relaxed);
+        }
+
+        m_RemainingNodes.store(static_cast<std::uint32_t>(m_Nodes.size()), std::memory_order_release);
+
+        for (UniquePtr<Node> & node : m_Nodes)
+        {
+            if (node->m_NumDependencies == 0)
+            {
+                PushNode(*node);
+            }
+        }
+    }
+
+    void TaskGraph::WaitForCompletion() const noexcept
+    {
+        while (true)
+        {
+            if (HelpWhileWaiting())
+            {
+                if (IsComplete())
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            const std::uint32_t remaining = m_RemainingNodes.load(std::memory_order_acquire);
+            if (remaining == 0)
+            {
+                break;
+            }
+
+            // Bounded for the same reasons as CoroBundle::WaitForCompletion, the graph may be destroyed as soon as we
+            // see 0 and we have to keep checking for jobs to help with, so without umwait/mwaitx this spins and yields
+            AtomicWait(m_RemainingNodes, remaining, AtomicWaitBoundedPolicy);
+        }
+    }
+
+    JobCoro<void> TaskGraph::RunNode(Node & node)
+    {
+        // Starts suspended, the first PushNode resumes us straight into the node's work
+        while (true)
+        {
+            if (node.m_CoroFactory)
+            {
+                co_await node.m_CoroFactory();
+            }
+            else
+            {
+                node.m_Function();
+            }
+
+            co_await NodeCompleteAwaiter{ *this, node };
+        }
+    }
+
+    void TaskGraph::OnNodeComplete(Node & node) noexcept
+    {
+        for (NodeId successor_id : node.m_Successors)
+        {
+            Node & successor = *m_Nodes[successor_id];
+            if (successor.m_PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                PushNode(successor);
+            }
+        }
+
+        m_RemainingNodes.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool TaskGraph::IsAcyclic() const noexcept
+    {
+        try
+        {
+            Vector<std::uint32_t> pending_dependencies;
+            pending_dependencies.reserve(m_Nodes.size());
+
+            Vector<NodeId> ready;
+            for (const UniquePtr<Node> & node : m_Nodes)
+            {
+                if (node->m_NumDependencies == 0)
+                {
+                    ready.push_back(static_cast<NodeId>(pending_dependencies.size()));
+                }
+
+                pending_dependencies.push_back(node->m_NumDependencies);
+            }
+
+            std::size_t num_visited = 0;
+            while (!ready.empty())
+            {
+                const NodeId node_id = ready.back();
+                ready.pop_back();
+                ++num_visited;
+
+                for (NodeId successor_id : m_Nodes[node_id]->m_Successors)
+                {
+                    if (--pending_dependencies[successor_id] == 0)
+                    {
+                        ready.push_back(successor_id);
+                    }
+                }
+            }
+
+            return num_visited == m_Nodes.size();
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    void TaskGraph::PushNode(Node & node) noexcept
+    {
+        g_JobManager->PushJob(node.m_Runner, node.m_Priority);
+    }
+}
@@ -0,0 +1,130 @@
+module;
+
+//import_std
+
+#include <cstddef>
+#include <cstdint>
+
+export module YT:ThreadTopology;
+
+import :Types;
+
+namespace YT
+{
+    export enum class CpuCoreType : std::uint8_t
+    {
+        Unknown,        ///< Not a hybrid machine, or the kernel doesn't say
+        Performance,
+        Efficiency,
+    };
+
+    /// The worker pools that pin their threads, in the order they take CPUs from the PackL3 list
+    export enum class ThreadPoolType : std::uint8_t
+    {
+        Job,
+        Background,
+        FileMapper,
+    };
+
+    /// Where one thread was allowed to run, see GetThreadCpuAssignments
+    export struct ThreadCpuAssignment
+    {
+        ThreadPoolType m_Pool = ThreadPoolType::Job;
+        std::size_t m_ThreadIndex = 0;
+        Vector<int> m_Cpus;     ///< A single CPU for PackL3 pool threads, the whole set when the thread floats
+    };
+
+    export struct CpuInfo
+    {
+        int m_Cpu = 0;
+        int m_Package = 0;
+        int m_Core = 0;         ///< Core id within the package, SMT siblings share it
+        int m_L3Domain = 0;     ///< Lowest CPU sharing this CPU's L3, or the lowest CPU in the package without L3 info
+        CpuCoreType m_CoreType = CpuCoreType::Unknown;
+    };
+
+    /**
+     * @brief The machine's CPU layout as reported by sysfs.
+     *
+     * Core types come from the hybrid PMU lists (/sys/devices/cpu_core and cpu_atom) or, failing that, from
+     * differing cpu_capacity values. L3 domains come from the cache entries of each CPU.
+     */
+    export class ThreadTopology
+    {
+    public:
+        /**
+         * @brief Reads the CPU layout.
+         *
+         * @param sysfs_root Normally /sys/devices, tests point it at a fake tree
+         * @return The layout, with no CPUs if the probe failed
+         */
+        [[nodiscard]] static ThreadTopology Probe(const StringView & sysfs_root = "/sys/devices") noexcept;
+
+        [[nodiscard]] const Vector<CpuInfo> & GetCpus() const noexcept
+        {
+            return m_Cpus;
+        }
+
+        [[nodiscard]] bool IsHybrid() const noexcept;
+        [[nodiscard]] std::size_t GetNumL3Domains() const noexcept;
+
+        /**
+         * @brief Picks the CPUs a pool should run on.
+         *
+         * For PackL3 the order is the order threads take them in: the L3 domain with the most non-efficiency
+         * cores first, one SMT sibling per core before the second siblings, then the next domain.
+         *
+         * @return The CPUs, empty for ThreadAffinityPolicy::None or when the probe found nothing
+         */
+        [[nodiscard]] Vector<int> SelectCpus(ThreadAffinityPolicy policy) const noexcept;
+
+        /**
+         * @brief Picks the CPUs one pool thread should run on, using the pool sizes and policies in Threading.
+         *
+         * PackL3 pools take consecutive runs of the PackL3 list in ThreadPoolType order, so threads from different
+         * pools only share a CPU once the list wraps around.
+         *
+         * @return A single CPU for PackL3, every CPU of the policy otherwise, empty for ThreadAffinityPolicy::None
+         */
+        [[nodiscard]] Vector<int> SelectThreadCpus(ThreadPoolType pool, std::size_t thread_index) const noexcept;
+
+        /// Every CPU the pool's threads may run on, for threads that help a pool without owning a slot in it
+        [[nodiscard]] Vector<int> SelectPoolCpus(ThreadPoolType pool) const noexcept;
+
+    private:
+        Vector<CpuInfo> m_Cpus;
+    };
+
+    /// Probed on first use and cached for the lifetime of the process
+    export [[nodiscard]] const ThreadTopology & GetThreadTopology() noexcept;
+
+    /**
+     * @brief Pins the calling thread according to its pool's policy and records it for GetThreadCpuAssignments.
+     *
+     * @param pool The pool the thread belongs to
+     * @param thread_index The thread's index within its pool, PackL3 uses it to pick a CPU
+     * @return true if an affinity was set
+     */
+    export bool ApplyThreadAffinity(ThreadPoolType pool, std::size_t thread_index) noexcept;
+
+    /**
+     * @brief Lets the calling thread float over every CPU of a pool instead of taking one of its slots.
+     *
+     * The main thread runs jobs as job thread 0 but also does everything else, so it isn't hard-pinned.
+     *
+     * @param pool The pool whose CPUs to float over
+     * @param thread_index Index the thread is recorded under for GetThreadCpuAssignments
+     * @return true if an affinity was set
+     */
+    export bool ApplyPoolAffinity(ThreadPoolType pool, std::size_t thread_index) noexcept;
+
+    /// The calling thread's current CPU set, to restore later with SetCurrentThreadAffinity
+    export [[nodiscard]] Vector<int> GetCurrentThreadAffinity() noexcept;
+    export bool SetCurrentThreadAffinity(const Vector<int> & cpus) noexcept;
+
+    /// The thread to CPU layout applied so far, one entry per pinned thread. A recreated pool replaces its entries.
+    export [[nodiscard]] Vector<ThreadCpuAssignment> GetThreadCpuAssignments() noexcept;
+
+    /// Parses sysfs CPU lists such as "0-3,8,10-11"
+    export [[nodiscard]] Vector<int> ParseCpuList(StringView list) noexcept;
+}
@@ -0,0 +1,586 @@
+module;
+
+//import_std
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+module YT:ThreadTopologyImpl;
+
+import :Types;
+import :ThreadTopology;
+
+namespace YT
+{
+    static constexpr int MaxCacheIndex = 16;
+
+    Optional<String> ReadSysfsFile(const String & path) noexcept
+    {
+        try
+        {
+            std::ifstream file(path);
+            String contents;
+            if (!file || !std::getline(file, contents))
+            {
+                return {};
+            }
+
+            return contents;
+        }
+        catch (...)
+        {
+            return {};
+        }
+    }
+
+    Optional<int> ReadSysfsInt(const String & path) noexcept
+    {
+        const Optional<String> contents = ReadSysfsFile(path);
+        if (!contents)
+        {
+            return {};
+        }
+
+        int value = 0;
+        const char * end = contents->data() + contents->size();
+        if (std::from_chars(contents->data(), end, value).ec != std::errc{})
+        {
+            return {};
+        }
+
+        return value;
+    }
+
+    Vector<int> ParseCpuList(StringView list) noexcept
+    {
+        Vector<int> cpus;
+
+        try
+        {
+            while (!list.empty())
+            {
+                const std::size_t comma = list.find(',');
+                StringView entry = list.substr(0, comma);
+                list = comma == StringView::npos ? StringView{} : list.substr(comma + 1);
+
+                while (!entry.empty() && (entry.front() == ' ' || entry.front() == '\n'))
+                {
+                    entry.remove_prefix(1);
+                }
+                while (!entry.empty() && (entry.back() == ' ' || entry.back() == '\n'))
+                {
+                    entry.remove_suffix(1);
+                }
+
+                int first = 0;
+                const char * const end = entry.data() + entry.size();
+                const std::from_chars_result first_result = std::from_chars(entry.data(), end, first);
+                if (first_result.ec != std::errc{})
+                {
+                    continue;
+                }
+
+                int last = first;
+                if (first_result.ptr != end && *first_result.ptr == '-')
+                {
+                    if (std::from_chars(first_result.ptr + 1, end, last).ec != std::errc{})
+                    {
+                        continue;
+                    }
+                }
+
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        catch (...)
+        {
+            cpus.clear();
+        }
+
+        return cpus;
+    }
+
+    Optional<int> FindL3Domain(const String & cpu_path) noexcept
+    {
+        for (int index = 0; index < MaxCacheIndex; ++index)
+        {
+            const String cache_path = Format("{}/cache/index{}", cpu_path, index);
+            const Optional<int> level = ReadSysfsInt(cache_path + "/level");
+            if (!level)
+            {
+                break;
+            }
+
+            if (*level != 3)
+            {
+                continue;
+            }
+
+            const Optional<String> shared = ReadSysfsFile(cache_path + "/shared_cpu_list");
+            if (!shared)
+            {
+                break;
+            }
+
+            const Vector<int> shared_cpus = ParseCpuList(*shared);
+            if (!shared_cpus.empty())
+            {
+                return *std::ranges::min_element(shared_cpus);
+            }
+        }
+
+        return {};
+    }
+
+    void ClassifyCoreTypes(Vector<CpuInfo> & cpus, const String & root, const Vector<String> & cpu_paths) noexcept
+    {
+        // Intel hybrid parts expose a PMU per core type
+        const Optional<String> performance_list = ReadSysfsFile(root + "/cpu_core/cpus");
+        const Optional<String> efficiency_list = ReadSysfsFile(root + "/cpu_atom/cpus");
+        if (performance_list || efficiency_list)
+        {
+            const Vector<int> performance = performance_list ? ParseCpuList(*performance_list) : Vector<int>{};
+            const Vector<int> efficiency = efficiency_list ? ParseCpuList(*efficiency_list) : Vector<int>{};
+
+            for (CpuInfo & cpu : cpus)
+            {
+                if (std::ranges::contains(performance, cpu.m_Cpu))
+                {
+                    cpu.m_CoreType = CpuCoreType::Performance;
+                }
+                else if (std::ranges::contains(efficiency, cpu.m_Cpu))
+                {
+                    cpu.m_CoreType = CpuCoreType::Efficiency;
+                }
+            }
+            return;
+        }
+
+        // big.LITTLE style parts report a relative capacity per CPU instead. Max frequency is deliberately not used,
+        // preferred-core boost makes it differ a little between identical cores.
+        Vector<int> capacities;
+        for (const String & cpu_path : cpu_paths)
+        {
+            const Optional<int> capacity = ReadSysfsInt(cpu_path + "/cpu_capacity");
+            if (!capacity)
+            {
+                return;
+            }
+            capacities.push_back(*capacity);
+        }
+
+        const auto [min_capacity, max_capacity] = std::ranges::minmax(capacities);
+        if (min_capacity == max_capacity)
+        {
+            return;
+        }
+
+        for (std::size_t index = 0; index < cpus.size(); ++index)
+        {
+            cpus[index].m_CoreType = capacities[index] == max_capacity ? CpuCoreType::Performance : CpuCoreType::Efficiency;
+        }
+    }
+
+    ThreadTopology ThreadTopology::Probe(const StringView & sysfs_root) noexcept
+    {
+        ThreadTopology topology;
+
+        try
+        {
+            const String root(sysfs_root);
+            const Optional<String> online = ReadSysfsFile(root + "/system/cpu/online");
+            if (!online)
+            {
+                return topology;
+            }
+
+            Vector<String> cpu_paths;
+            for (int cpu : ParseCpuList(*online))
+            {
+                const String cpu_path = Format("{}/system/cpu/cpu{}", root, cpu);
+
+                CpuInfo & info = topology.m_Cpus.emplace_back();
+                info.m_Cpu = cpu;
+                info.m_Package = ReadSysfsInt(cpu_path + "/topology/physical_package_id").value_or(0);
+                info.m_Core = ReadSysfsInt(cpu_path + "/topology/core_id").value_or(cpu);
+                info.m_L3Domain = FindL3Domain(cpu_path).value_or(-1);
+
+                cpu_paths.push_back(cpu_path);
+            }
+
+            // Without cache info treat each package as one domain
+            for (CpuInfo & info : topology.m_Cpus)
+            {
+                if (info.m_L3Domain < 0)
+                {
+                    const auto first_in_package = std::ranges::find(topology.m_Cpus, info.m_Package, &CpuInfo::m_Package);
+                    info.m_L3Domain = first_in_package->m_Cpu;
+                }
+            }
+
+            ClassifyCoreTypes(topology.m_Cpus, root, cpu_paths);
+        }
+        catch (...)
+        {
+            topology.m_Cpus.clear();
+        }
+
+        return topology;
+    }
+
+    bool ThreadTopology::IsHybrid() const noexcept
+    {
+        return std::ranges::any_of(m_Cpus, [](const CpuInfo & cpu) { return cpu.m_CoreType == CpuCoreType::Efficiency; });
+    }
+
+    std::size_t ThreadTopology::GetNumL3Domains() const noexcept
+    {
+        std::size_t count = 0;
+        for (std::size_t index = 0; index < m_Cpus.size(); ++index)
+        {
+            const bool seen = std::ranges::any_of(m_Cpus.begin(), m_Cpus.begin() + index, [&](const CpuInfo & cpu)
+            {
+                return cpu.m_L3Domain == m_Cpus[index].m_L3Domain;
+            });
+
+            if (!seen)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    Vector<int> ThreadTopology::SelectCpus(ThreadAffinityPolicy policy) const noexcept
+    {
+        Vector<int> cpus;
+
+        try
+        {
+            auto SelectCoreType = [&](CpuCoreType core_type)
+            {
+                for (const CpuInfo & cpu : m_Cpus)
+                {
+                    if (cpu.m_CoreType == core_type)
+                    {
+                        cpus.push_back(cpu.m_Cpu);
+                    }
+                }
+
+                // Not a hybrid machine so every core qualifies
+                if (cpus.empty())
+                {
+                    for (const CpuInfo & cpu : m_Cpus)
+                    {
+                        cpus.push_back(cpu.m_Cpu);
+                    }
+                }
+            };
+
+            switch (policy)
+            {
+                case ThreadAffinityPolicy::None:
+                    break;
+                case ThreadAffinityPolicy::PerformanceCores:
+                    SelectCoreType(CpuCoreType::Performance);
+                    break;
+                case ThreadAffinityPolicy::EfficiencyCores:
+                    SelectCoreType(CpuCoreType::Efficiency);
+                    break;
+                case ThreadAffinityPolicy::PackL3:
+                {
+                    struct Domain
+                    {
+                        int m_Id = 0;
+                        int m_FastCpus = 0;
+                    };
+
+                    Vector<Domain> domains;
+                    for (const CpuInfo & cpu : m_Cpus)
+                    {
+                        auto domain = std::ranges::find(domains, cpu.m_L3Domain, &Domain::m_Id);
+                        if (domain == domains.end())
+                        {
+                            domain = domains.insert(domains.end(), Domain{ .m_Id = cpu.m_L3Domain });
+                        }
+
+                        if (cpu.m_CoreType != CpuCoreType::Efficiency)
+                        {
+                            ++domain->m_FastCpus;
+                        }
+                    }
+
+                    std::ranges::stable_sort(domains, [](const Domain & lhs, const Domain & rhs)
+                    {
+                        return lhs.m_FastCpus != rhs.m_FastCpus ? lhs.m_FastCpus > rhs.m_FastCpus : lhs.m_Id < rhs.m_Id;
+                    });
+
+                    for (const Domain & domain : domains)
+                    {
+                        // Rank each CPU by how many of its SMT siblings come before it, so every core gets a
+                        // thread before any core gets two. Fast cores go ahead of efficiency cores in each rank.
+                        Vector<std::pair<int, const CpuInfo *>> ranked;
+                        for (const CpuInfo & cpu : m_Cpus)
+                        {
+                            if (cpu.m_L3Domain != domain.m_Id)
+                            {
+                                continue;
+                            }
+
+                            const int sibling_rank = static_cast<int>(std::ranges::count_if(ranked, [&](const auto & entry)
+                            {
+                                return entry.second->m_Package == cpu.m_Package && entry.second->m_Core == cpu.m_Core;
+                            }));
+                            ranked.emplace_back(sibling_rank, &cpu);
+                        }
+
+                        std::ranges::stable_sort(ranked, [](const auto & lhs, const auto & rhs)
+                        {
+                            if (lhs.first != rhs.first)
+                            {
+                                return lhs.first < rhs.first;
+                            }
+                            return (lhs.second->m_CoreType != CpuCoreType::Efficiency) > (rhs.second->m_CoreType != CpuCoreType::Efficiency);
+                        });
+
+                        for (const auto & [rank, cpu] : ranked)
+                        {
+                            cpus.push_back(cpu->m_Cpu);
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            cpus.clear();
+        }
+
+        return cpus;
+    }
+
+    ThreadAffinityPolicy GetPoolAffinityPolicy(ThreadPoolType pool) noexcept
+    {
+        switch (pool)
+        {
+            case ThreadPoolType::Job:
+                return Threading::GetJobThreadAffinity();
+            case ThreadPoolType::Background:
+                return Threading::GetBackgroundThreadAffinity();
+            case ThreadPoolType::FileMapper:
+                return Threading::GetFileMapperThreadAffinity();
+        }
+
+        return ThreadAffinityPolicy::None;
+    }
+
+    std::size_t GetPoolSize(ThreadPoolType pool) noexcept
+    {
+        switch (pool)
+        {
+            case ThreadPoolType::Job:
+                return Threading::GetNumJobThreads();
+            case ThreadPoolType::Background:
+                return Threading::GetNumBackgroundThreads();
+            case ThreadPoolType::FileMapper:
+                return Threading::GetNumFileMapperThreads();
+        }
+
+        return 0;
+    }
+
+    /// Index of the pool's first thread in the PackL3 list, every PackL3 pool before it in ThreadPoolType order comes first
+    std::size_t GetPackL3SlotOffset(ThreadPoolType pool) noexcept
+    {
+        std::size_t offset = 0;
+        for (ThreadPoolType earlier_pool : { ThreadPoolType::Job, ThreadPoolType::Background, ThreadPoolType::FileMapper })
+        {
+            if (earlier_pool == pool)
+            {
+                break;
+            }
+
+            if (GetPoolAffinityPolicy(earlier_pool) == ThreadAffinityPolicy::PackL3)
+            {
+                offset += GetPoolSize(earlier_pool);
+            }
+        }
+
+        return offset;
+    }
+
+    Vector<int> ThreadTopology::SelectThreadCpus(ThreadPoolType pool, std::size_t thread_index) const noexcept
+    {
+        const ThreadAffinityPolicy policy = GetPoolAffinityPolicy(pool);
+        Vector<int> cpus = SelectCpus(policy);
+        if (cpus.empty() || policy != ThreadAffinityPolicy::PackL3)
+        {
+            return cpus;
+        }
+
+        // More threads than CPUs wraps around rather than leaving threads unpinned
+        const int cpu = cpus[(GetPackL3SlotOffset(pool) + thread_index) % cpus.size()];
+        cpus.clear();
+        cpus.push_back(cpu);
+        return cpus;
+    }
+
+    Vector<int> ThreadTopology::SelectPoolCpus(ThreadPoolType pool) const noexcept
+    {
+        const ThreadAffinityPolicy policy = GetPoolAffinityPolicy(pool);
+        Vector<int> cpus = SelectCpus(policy);
+        if (cpus.empty() || policy != ThreadAffinityPolicy::PackL3)
+        {
+            return cpus;
+        }
+
+        try
+        {
+            const std::size_t offset = GetPackL3SlotOffset(pool);
+            const std::size_t count = std::min(GetPoolSize(pool), cpus.size());
+
+            Vector<int> pool_cpus;
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                pool_cpus.push_back(cpus[(offset + index) % cpus.size()]);
+            }
+
+            return pool_cpus;
+        }
+        catch (...)
+        {
+            return {};
+        }
+    }
+
+    const ThreadTopology & GetThreadTopology() noexcept
+    {
+        static const ThreadTopology s_Topology = ThreadTopology::Probe();
+        return s_Topology;
+    }
+
+    std::mutex g_ThreadCpuAssignmentMutex;
+    Vector<ThreadCpuAssignment> g_ThreadCpuAssignments;
+
+    void RecordThreadCpuAssignment(ThreadPoolType pool, std::size_t thread_index, const Vector<int> & cpus) noexcept
+    {
+        try
+        {
+            std::lock_guard lock(g_ThreadCpuAssignmentMutex);
+
+            auto assignment = std::ranges::find_if(g_ThreadCpuAssignments, [&](const ThreadCpuAssignment & entry)
+            {
+                return entry.m_Pool == pool && entry.m_ThreadIndex == thread_index;
+            });
+
+            if (assignment == g_ThreadCpuAssignments.end())
+            {
+                assignment = g_ThreadCpuAssignments.insert(g_ThreadCpuAssignments.end(),
+                    ThreadCpuAssignment{ .m_Pool = pool, .m_ThreadIndex = thread_index });
+            }
+
+            assignment->m_Cpus = cpus;
+        }
+        catch (...)
+        {
+        }
+    }
+
+    bool SetCurrentThreadAffinity(const Vector<int> & cpus) noexcept
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+
+        bool any_set = false;
+        for (int cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &cpu_set);
+                any_set = true;
+            }
+        }
+
+        return any_set && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+
+    Vector<int> GetCurrentThreadAffinity() noexcept
+    {
+        Vector<int> cpus;
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+        {
+            return cpus;
+        }
+
+        try
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &cpu_set))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        catch (...)
+        {
+            cpus.clear();
+        }
+
+        return cpus;
+    }
+
+    bool ApplyThreadAffinity(ThreadPoolType pool, std::size_t thread_index) noexcept
+    {
+        const Vector<int> cpus = GetThreadTopology().SelectThreadCpus(pool, thread_index);
+        if (!SetCurrentThreadAffinity(cpus))
+        {
+            return false;
+        }
+
+        RecordThreadCpuAssignment(pool, thread_index, cpus);
+        return true;
+    }
+
+    bool ApplyPoolAffinity(ThreadPoolType pool, std::size_t thread_index) noexcept
+    {
+        const Vector<int> cpus = GetThreadTopology().SelectPoolCpus(pool);
+        if (!SetCurrentThreadAffinity(cpus))
+        {
+            return false;
+        }
+
+        RecordThreadCpuAssignment(pool, thread_index, cpus);
+        return true;
+    }
+
+    Vector<ThreadCpuAssignment> GetThreadCpuAssignments() noexcept
+    {
+        try
+        {
+            std::lock_guard lock(g_ThreadCpuAssignmentMutex);
+            return g_ThreadCpuAssignments;
+        }
+        catch (...)
+        {
+            return {};
+        }
+    }
+}
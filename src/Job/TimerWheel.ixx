@@ -0,0 +1,96 @@
+module;
+
+//import_std
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+export module YT:TimerWheel;
+
+namespace YT
+{
+    /// A pending timer, embedded in whatever owns it (usually an awaiter) so scheduling never allocates
+    export struct TimerWheelNode
+    {
+        std::uint64_t m_ExpiryTick = 0;
+        void (*m_OnExpire)(TimerWheelNode & node) noexcept = nullptr;    ///< Called once the expiry tick is reached
+        TimerWheelNode * m_Next = nullptr;
+    };
+
+    /**
+     * @brief Hierarchical timer wheel.
+     *
+     * Four levels of 256/64/64/64 slots cover 2^26 ticks, further timers are parked in the top level and
+     * re-placed as the wheel turns. Inserting and firing a timer is O(1), and each tick touches at most one slot
+     * per level no matter how many timers are pending.
+     *
+     * Schedule can be called from any thread and pushes onto a lock-free list. Advance must only be called from
+     * one thread at a time, it moves new timers into the wheel and fires everything that is due.
+     */
+    export class TimerWheel final
+    {
+    public:
+        static constexpr std::size_t Level0Bits = 8;
+        static constexpr std::size_t LevelBits = 6;
+        static constexpr std::size_t NumUpperLevels = 3;
+        static constexpr std::uint64_t MaxRange = std::uint64_t{ 1 } << (Level0Bits + LevelBits * NumUpperLevels);
+
+        explicit TimerWheel(std::uint64_t start_tick = 0) noexcept
+            : m_CurrentTick(start_tick)
+        {}
+
+        TimerWheel(const TimerWheel &) = delete;
+        TimerWheel(TimerWheel &&) = delete;
+        TimerWheel & operator=(const TimerWheel &) = delete;
+        TimerWheel & operator=(TimerWheel &&) = delete;
+
+        /**
+         * @brief Adds a timer. Timers already due fire on the next Advance.
+         *
+         * @param node The timer, must stay alive until its callback runs
+         */
+        void Schedule(TimerWheelNode & node) noexcept;
+
+        /**
+         * @brief Turns the wheel up to now_tick and fires every timer that is due.
+         *
+         * @return Number of timers fired
+         */
+        std::size_t Advance(std::uint64_t now_tick) noexcept;
+
+        [[nodiscard]] std::uint64_t GetCurrentTick() const noexcept
+        {
+            return m_CurrentTick;
+        }
+
+        /// Timers in the wheel, not counting ones scheduled since the last Advance
+        [[nodiscard]] std::size_t GetNumPendingTimers() const noexcept
+        {
+            return m_NumTimers;
+        }
+
+    private:
+        static constexpr std::size_t Level0Size = std::size_t{ 1 } << Level0Bits;
+        static constexpr std::size_t LevelSize = std::size_t{ 1 } << LevelBits;
+
+        void Insert(TimerWheelNode & node) noexcept;
+        void Cascade(std::size_t level, std::size_t index) noexcept;
+
+        static void PushSlot(TimerWheelNode *& slot, TimerWheelNode & node) noexcept
+        {
+            node.m_Next = slot;
+            slot = &node;
+        }
+
+    private:
+        std::atomic<TimerWheelNode *> m_Incoming = nullptr;  ///< Timers scheduled since the last Advance
+        std::uint64_t m_CurrentTick = 0;
+        std::size_t m_NumTimers = 0;
+        TimerWheelNode * m_Due = nullptr;
+
+        std::array<TimerWheelNode *, Level0Size> m_Level0 = {};
+        std::array<std::array<TimerWheelNode *, LevelSize>, NumUpperLevels> m_Levels = {};
+    };
+}
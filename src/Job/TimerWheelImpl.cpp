@@ -0,0 +1,121 @@
+module;
+
+//import_std
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+module YT:TimerWheelImpl;
+
+import :TimerWheel;
+
+namespace YT
+{
+    void TimerWheel::Schedule(TimerWheelNode & node) noexcept
+    {
+        TimerWheelNode * head = m_Incoming.load(std::memory_order_relaxed);
+        do
+        {
+            node.m_Next = head;
+        }
+        while (!m_Incoming.compare_exchange_weak(head, &node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    std::size_t TimerWheel::Advance(std::uint64_t now_tick) noexcept
+    {
+        for (TimerWheelNode * node = m_Incoming.exchange(nullptr, std::memory_order_acquire); node != nullptr; )
+        {
+            TimerWheelNode * const next = node->m_Next;
+            ++m_NumTimers;
+            Insert(*node);
+            node = next;
+        }
+
+        while (m_CurrentTick < now_tick)
+        {
+            if (m_NumTimers == 0)
+            {
+                // Nothing to turn over, skip straight to now
+                m_CurrentTick = now_tick;
+                break;
+            }
+
+            ++m_CurrentTick;
+
+            const std::size_t index = m_CurrentTick & (Level0Size - 1);
+            if (index == 0)
+            {
+                // Level 0 wrapped, pull the next slot of each level down a level for as far as the wrap carries
+                for (std::size_t level = 0; level < NumUpperLevels; ++level)
+                {
+                    const std::size_t level_index = (m_CurrentTick >> (Level0Bits + LevelBits * level)) & (LevelSize - 1);
+                    Cascade(level, level_index);
+                    if (level_index != 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            for (TimerWheelNode * node = std::exchange(m_Level0[index], nullptr); node != nullptr; )
+            {
+                TimerWheelNode * const next = node->m_Next;
+                PushSlot(m_Due, *node);
+                node = next;
+            }
+        }
+
+        std::size_t fired = 0;
+        while (TimerWheelNode * node = m_Due)
+        {
+            // The callback may free the node, so step past it first
+            m_Due = node->m_Next;
+            --m_NumTimers;
+            ++fired;
+            node->m_OnExpire(*node);
+        }
+
+        return fired;
+    }
+
+    void TimerWheel::Insert(TimerWheelNode & node) noexcept
+    {
+        if (node.m_ExpiryTick <= m_CurrentTick)
+        {
+            PushSlot(m_Due, node);
+            return;
+        }
+
+        const std::uint64_t delta = node.m_ExpiryTick - m_CurrentTick;
+        if (delta < Level0Size)
+        {
+            PushSlot(m_Level0[node.m_ExpiryTick & (Level0Size - 1)], node);
+            return;
+        }
+
+        // Past the wheel's range the timer waits in the furthest slot and gets re-placed when that slot cascades
+        const std::uint64_t placement_tick = delta < MaxRange ? node.m_ExpiryTick : m_CurrentTick + MaxRange - 1;
+        for (std::size_t level = 0; level < NumUpperLevels; ++level)
+        {
+            const std::size_t shift = Level0Bits + LevelBits * level;
+            if (delta < (std::uint64_t{ 1 } << (shift + LevelBits)) || level == NumUpperLevels - 1)
+            {
+                PushSlot(m_Levels[level][(placement_tick >> shift) & (LevelSize - 1)], node);
+                return;
+            }
+        }
+    }
+
+    void TimerWheel::Cascade(std::size_t level, std::size_t index) noexcept
+    {
+        for (TimerWheelNode * node = std::exchange(m_Levels[level][index], nullptr); node != nullptr; )
+        {
+            TimerWheelNode * const next = node->m_Next;
+            Insert(*node);
+            node = next;
+        }
+    }
+}
@@ -1,7 +1,9 @@
 module;
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <thread>
 
 #include "WaitImpl.h"
 
@@ -12,18 +14,108 @@ namespace YT
     export void (*MonitorAddr)(const void *) = MonitorFallback;
     export void (*WaitForAddr)(std::uint32_t) = WaitFallback;
 
+    /// True once InitWait found umwait or mwaitx, MonitorAddr/WaitForAddr are just a pause otherwise
+    export bool g_HasMonitorWait = false;
+
     export void InitWait()
     {
         if (SupportsIntelWait())
         {
             MonitorAddr = MonitorIntel;
             WaitForAddr = WaitIntel;
+            g_HasMonitorWait = true;
         }
         else if (SupportsAmdWait())
         {
             MonitorAddr = MonitorAmd;
             WaitForAddr = WaitAmd;
+            g_HasMonitorWait = true;
+        }
+    }
+
+    /// How far AtomicWait escalates before it sleeps in the kernel or gives up
+    export struct AtomicWaitPolicy
+    {
+        std::uint32_t m_SpinCount = 64;             ///< Pause loops re-checking the value
+        std::uint32_t m_MonitorCount = 64;          ///< umwait/mwaitx naps, skipped on CPUs without either
+        std::uint32_t m_MonitorTimeout = 100000;    ///< Cycles per nap
+
+        /**
+         * Finish by sleeping on a futex until AtomicNotify. Only safe when every writer calls AtomicNotify and the
+         * atomic outlives those calls. Without it AtomicWait yields once and returns so the caller can re-check.
+         */
+        bool m_Park = true;
+    };
+
+    /// For long-lived counters whose writers always AtomicNotify, ends up parked on the futex
+    export constexpr AtomicWaitPolicy AtomicWaitParkPolicy = {};
+
+    /// For waits on objects that can be destroyed as soon as the value flips, or where the caller has other work to check
+    export constexpr AtomicWaitPolicy AtomicWaitBoundedPolicy =
+    {
+        .m_SpinCount = 64,
+        .m_MonitorCount = 1,
+        .m_MonitorTimeout = 150000,
+        .m_Park = false,
+    };
+
+    /**
+     * @brief Waits for an atomic to change from old, escalating from pause to umwait/mwaitx to a futex.
+     *
+     * Replaces MonitorAddr/WaitForAddr loops that spun flat out on CPUs without waitpkg or mwaitx.
+     *
+     * @param atomic The value to watch
+     * @param old The value it had when the caller decided to wait
+     * @param policy How far to escalate, see AtomicWaitPolicy::m_Park for when parking is allowed
+     * @return true if the value changed, false if a bounded policy gave up first
+     */
+    export template <typename T>
+    bool AtomicWait(const std::atomic<T> & atomic, T old, const AtomicWaitPolicy & policy = AtomicWaitParkPolicy) noexcept
+    {
+        for (std::uint32_t i = 0; i < policy.m_SpinCount; ++i)
+        {
+            if (atomic.load(std::memory_order_acquire) != old)
+            {
+                return true;
+            }
+
+            CpuPause();
+        }
+
+        if (g_HasMonitorWait)
+        {
+            for (std::uint32_t i = 0; i < policy.m_MonitorCount; ++i)
+            {
+                MonitorAddr(&atomic);
+                if (atomic.load(std::memory_order_acquire) != old)
+                {
+                    return true;
+                }
+
+                WaitForAddr(policy.m_MonitorTimeout);
+            }
+        }
+
+        if (!policy.m_Park)
+        {
+            if (atomic.load(std::memory_order_acquire) != old)
+            {
+                return true;
+            }
+
+            std::this_thread::yield();
+            return atomic.load(std::memory_order_acquire) != old;
         }
+
+        // std::atomic::wait is a futex wait on Linux, and skips the syscall if the value already moved on
+        atomic.wait(old, std::memory_order_acquire);
+        return true;
     }
 
+    /// Wakes everything parked in AtomicWait on this atomic, cheap when nobody is parked
+    export template <typename T>
+    void AtomicNotify(std::atomic<T> & atomic) noexcept
+    {
+        atomic.notify_all();
+    }
 }
@@ -53,7 +53,8 @@ namespace YT
     __attribute__((target("waitpkg")))
     void WaitIntel(std::uint32_t timeout)
     {
-        _umwait(0, timeout);
+        // umwait takes an absolute TSC deadline rather than a duration
+        _umwait(0, __rdtsc() + timeout);
     }
 
     __attribute__((target("mwaitx")))
@@ -66,5 +67,10 @@ namespace YT
     {
         _mm_pause();
     }
+
+    void CpuPause()
+    {
+        _mm_pause();
+    }
 }
 
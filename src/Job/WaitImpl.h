@@ -17,6 +17,8 @@ namespace YT
     void WaitIntel(std::uint32_t timeout);
     void WaitAmd(std::uint32_t timeout);
     void WaitFallback(std::uint32_t timeout);
+
+    void CpuPause();
 }
 
 
@@ -1,6 +1,9 @@
 
 module;
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <mutex>
 
 export module YT:WorkerThreadQueue;
@@ -8,6 +11,7 @@ export module YT:WorkerThreadQueue;
 import :Types;
 import :JobTypes;
 import :MultiProducerSingleConsumer;
+import :SpillQueue;
 
 namespace YT
 {
@@ -16,14 +20,51 @@ namespace YT
     public:
         explicit WorkerThreadQueue(ThreadContextType thread_context_type);
 
-        void PushWork(Function<void()> && work) noexcept;
+        void PushWork(WorkFunction && work) noexcept;
+
+        /// Runs everything queued, including work pushed while draining. Returns how many items ran. May be called
+        /// from inside an item this queue is running, other threads calling it meanwhile run nothing.
         int TryExecuteWork() noexcept;
 
+        /**
+         * @brief Runs queued work until the queue is empty or the budget is used up, whichever comes first.
+         *
+         * The budget is checked between items, so at least one item runs and a long item can overshoot it.
+         * Anything left stays queued for the next call.
+         *
+         * @param budget How long to keep taking new items for
+         * @return How many items ran
+         */
+        int TryExecuteWork(std::chrono::nanoseconds budget) noexcept;
+
+        [[nodiscard]] bool HasWork() const noexcept
+        {
+            return !m_Queue.Empty();
+        }
+
         [[nodiscard]] ThreadContextType GetThreadContextType() const noexcept;
+
+        [[nodiscard]] SpillQueueStats GetSpillStats() const noexcept
+        {
+            return m_Queue.GetStats();
+        }
     private:
 
+        /// Next item to run, leftovers of an enclosing drain's batch first so nested drains keep FIFO order. Needs m_Mutex.
+        [[nodiscard]] bool TryPopWork(WorkFunction & work, bool bulk) noexcept;
+
+        static constexpr std::size_t DrainBatchSize = 16;     ///< Items the unbudgeted drain takes per dequeue
+
         ThreadContextType m_ThreadContextType;
-        std::mutex m_Mutex;
-        MultiProducerSingleConsumer<Function<void()>, 2048> m_Queue;
+
+        /// Recursive so an item that blocks and helps while it waits (HelpWhileWaiting) can drain nested items, the
+        /// draining thread is still the only consumer
+        std::recursive_mutex m_Mutex;
+        SpillQueue<WorkFunction, 2048, MultiProducerSingleConsumer> m_Queue;
+
+        /// Dequeued but not yet run, guarded by m_Mutex. A member so a nested drain can reach them.
+        std::array<WorkFunction, DrainBatchSize> m_Batch;
+        std::size_t m_BatchNext = 0;
+        std::size_t m_BatchCount = 0;
     };
 }
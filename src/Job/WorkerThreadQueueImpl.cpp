@@ -3,8 +3,12 @@ module;
 
 //import_std
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <thread>
 #include <new>
+#include <utility>
 
 module YT:WorkerThreadQueueImpl;
 
@@ -12,6 +16,7 @@ import :Types;
 import :Coroutine;
 import :WorkerThread;
 import :MultiProducerSingleConsumer;
+import :SpillQueue;
 import :BackgroundTaskManager;
 
 namespace YT
@@ -22,12 +27,9 @@ namespace YT
 
     }
 
-    void WorkerThreadQueue::PushWork(Function<void()> && work) noexcept
+    void WorkerThreadQueue::PushWork(WorkFunction && work) noexcept
     {
-        while (!m_Queue.TryEnqueue(std::move(work)))
-        {
-            std::this_thread::yield();
-        }
+        m_Queue.Enqueue(std::move(work));
 
         if (m_ThreadContextType != ThreadContextType::Main &&
             m_ThreadContextType != ThreadContextType::Job &&
@@ -37,16 +39,62 @@ namespace YT
         }
     }
 
+    bool WorkerThreadQueue::TryPopWork(WorkFunction & work, bool bulk) noexcept
+    {
+        if (m_BatchNext == m_BatchCount)
+        {
+            if (!bulk)
+            {
+                return m_Queue.TryDequeue(work);
+            }
+
+            m_BatchNext = 0;
+            m_BatchCount = m_Queue.TryDequeueBulk(m_Batch.data(), m_Batch.size());
+            if (m_BatchCount == 0)
+            {
+                return false;
+            }
+        }
+
+        work = std::move(m_Batch[m_BatchNext++]);
+        return true;
+    }
+
     int WorkerThreadQueue::TryExecuteWork() noexcept
     {
         int work_completed = 0;
         if (m_Mutex.try_lock())
         {
-            Function<void()> work;
-            while (m_Queue.TryDequeue(work))
+            WorkFunction work;
+            while (TryPopWork(work, true))
+            {
+                work_completed++;
+                work();
+            }
+
+            m_Mutex.unlock();
+        }
+
+        return work_completed;
+    }
+
+    int WorkerThreadQueue::TryExecuteWork(std::chrono::nanoseconds budget) noexcept
+    {
+        int work_completed = 0;
+        if (m_Mutex.try_lock())
+        {
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + budget;
+
+            WorkFunction work;
+            while (TryPopWork(work, false))
             {
                 work_completed++;
                 work();
+
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    break;
+                }
             }
 
             m_Mutex.unlock();
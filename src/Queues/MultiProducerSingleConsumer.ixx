@@ -6,6 +6,7 @@ module;
 #include <atomic>
 #include <cstddef>
 #include <new>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -57,12 +58,20 @@ namespace YT
             {
                 Slot & slot = m_Slots[position % Capacity];
                 const std::size_t sequence = slot.m_Sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
 
-                if (sequence != position)
+                if (difference < 0)
                 {
                     return false;
                 }
 
+                if (difference > 0)
+                {
+                    // Another producer got in first, that's contention rather than a full queue
+                    position = m_EnqueuePos.load(std::memory_order_relaxed);
+                    continue;
+                }
+
                 if (m_EnqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_acq_rel))
                 {
                     new (SlotPtr(slot)) T(std::forward<Args>(args)...);
@@ -93,6 +102,100 @@ namespace YT
             return true;
         }
 
+        /**
+         * @brief Enqueues as many of values as fit, reserving their slots with a single CAS.
+         *
+         * @param values Moved from, in order. Only the first returned count are taken.
+         * @return How many values were enqueued, 0 when the queue is full
+         */
+        [[nodiscard]] std::size_t TryEnqueueBulk(std::span<T> values) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (values.empty())
+            {
+                return 0;
+            }
+
+            std::size_t position = m_EnqueuePos.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                const std::size_t sequence = m_Slots[position % Capacity].m_Sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                if (difference < 0)
+                {
+                    return 0;
+                }
+
+                if (difference > 0)
+                {
+                    // Another producer got in first
+                    position = m_EnqueuePos.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                // A slot can only be claimed by moving m_EnqueuePos past it, so if the CAS succeeds these are still free
+                std::size_t count = 1;
+                while (count < values.size() && count < Capacity &&
+                    m_Slots[(position + count) % Capacity].m_Sequence.load(std::memory_order_acquire) == position + count)
+                {
+                    ++count;
+                }
+
+                if (m_EnqueuePos.compare_exchange_weak(position, position + count, std::memory_order_acq_rel))
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        Slot & slot = m_Slots[(position + i) % Capacity];
+                        new (SlotPtr(slot)) T(std::move(values[i]));
+                        slot.m_Sequence.store(position + i + 1, std::memory_order_release);
+                    }
+
+                    return count;
+                }
+            }
+        }
+
+        /**
+         * @brief Dequeues up to max values and publishes the new dequeue position once for the whole batch.
+         *
+         * Call from one consumer thread only, like TryDequeue.
+         *
+         * @param out Output iterator the values are moved to, e.g. a pointer into an array or a back_inserter
+         * @param max Most values to take
+         * @return How many values were dequeued
+         */
+        template <typename OutputIt>
+        [[nodiscard]] std::size_t TryDequeueBulk(OutputIt out, std::size_t max) noexcept(std::is_nothrow_move_assignable_v<T> &&
+                                                                                         std::is_nothrow_move_constructible_v<T>)
+        {
+            const std::size_t position = m_DequeuePos.load(std::memory_order_relaxed);
+
+            std::size_t count = 0;
+            while (count < max)
+            {
+                Slot & slot = m_Slots[(position + count) % Capacity];
+                if (slot.m_Sequence.load(std::memory_order_acquire) != position + count + 1)
+                {
+                    break;
+                }
+
+                T * value_ptr = SlotPtr(slot);
+                *out = std::move(*value_ptr);
+                ++out;
+                value_ptr->~T();
+                slot.m_Sequence.store(position + count + Capacity, std::memory_order_release);
+                ++count;
+            }
+
+            if (count != 0)
+            {
+                m_DequeuePos.store(position + count, std::memory_order_release);
+            }
+
+            return count;
+        }
+
         [[nodiscard]] bool Empty() const noexcept
         {
             return Size() == 0;
@@ -6,6 +6,7 @@ module;
 #include <atomic>
 #include <cstddef>
 #include <new>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -75,12 +76,20 @@ namespace YT
             {
                 Slot & slot = m_Slots[position % Capacity];
                 const std::size_t sequence = slot.m_Sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
 
-                if (sequence != position + 1)
+                if (difference < 0)
                 {
                     return false;
                 }
 
+                if (difference > 0)
+                {
+                    // Another consumer got in first, that's contention rather than an empty queue
+                    position = m_DequeuePos.load(std::memory_order_relaxed);
+                    continue;
+                }
+
                 if (m_DequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_acq_rel))
                 {
                     T * value_ptr = SlotPtr(slot);
@@ -92,6 +101,99 @@ namespace YT
             }
         }
 
+        /**
+         * @brief Enqueues as many of values as fit and publishes the new enqueue position once for the whole batch.
+         *
+         * Call from one producer thread only, like Emplace.
+         *
+         * @param values Moved from, in order. Only the first returned count are taken.
+         * @return How many values were enqueued, 0 when the queue is full
+         */
+        [[nodiscard]] std::size_t TryEnqueueBulk(std::span<T> values) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            const std::size_t position = m_EnqueuePos.load(std::memory_order_relaxed);
+
+            std::size_t count = 0;
+            while (count < values.size())
+            {
+                Slot & slot = m_Slots[(position + count) % Capacity];
+                if (slot.m_Sequence.load(std::memory_order_acquire) != position + count)
+                {
+                    break;
+                }
+
+                new (SlotPtr(slot)) T(std::move(values[count]));
+                slot.m_Sequence.store(position + count + 1, std::memory_order_release);
+                ++count;
+            }
+
+            if (count != 0)
+            {
+                m_EnqueuePos.store(position + count, std::memory_order_relaxed);
+            }
+
+            return count;
+        }
+
+        /**
+         * @brief Dequeues up to max values, claiming their slots with a single CAS.
+         *
+         * @param out Output iterator the values are moved to, e.g. a pointer into an array or a back_inserter
+         * @param max Most values to take
+         * @return How many values were dequeued
+         */
+        template <typename OutputIt>
+        [[nodiscard]] std::size_t TryDequeueBulk(OutputIt out, std::size_t max) noexcept(std::is_nothrow_move_assignable_v<T> &&
+                                                                                         std::is_nothrow_move_constructible_v<T>)
+        {
+            if (max == 0)
+            {
+                return 0;
+            }
+
+            std::size_t position = m_DequeuePos.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                const std::size_t sequence = m_Slots[position % Capacity].m_Sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+                if (difference < 0)
+                {
+                    return 0;
+                }
+
+                if (difference > 0)
+                {
+                    // Another consumer got in first
+                    position = m_DequeuePos.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                std::size_t count = 1;
+                while (count < max && count < Capacity &&
+                    m_Slots[(position + count) % Capacity].m_Sequence.load(std::memory_order_acquire) == position + count + 1)
+                {
+                    ++count;
+                }
+
+                if (m_DequeuePos.compare_exchange_weak(position, position + count, std::memory_order_acq_rel))
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        Slot & slot = m_Slots[(position + i) % Capacity];
+                        T * value_ptr = SlotPtr(slot);
+                        *out = std::move(*value_ptr);
+                        ++out;
+                        value_ptr->~T();
+                        slot.m_Sequence.store(position + i + Capacity, std::memory_order_release);
+                    }
+
+                    return count;
+                }
+            }
+        }
+
         [[nodiscard]] bool Empty() const noexcept
         {
             return Size() == 0;
@@ -2,10 +2,12 @@ module;
 
 //import_std
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
 #include <new>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -75,6 +77,62 @@ namespace YT
             return true;
         }
 
+        /**
+         * @brief Enqueues as many of values as fit and publishes them with a single store.
+         *
+         * @param values Moved from, in order. Only the first returned count are taken.
+         * @return How many values were enqueued, 0 when the queue is full
+         */
+        [[nodiscard]] std::size_t TryEnqueueBulk(std::span<T> values) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+            const std::size_t head = m_Head.load(std::memory_order_acquire);
+
+            const std::size_t count = std::min(values.size(), Capacity - (tail - head));
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                new (SlotPtr(tail + i)) T(std::move(values[i]));
+            }
+
+            if (count != 0)
+            {
+                m_Tail.store(tail + count, std::memory_order_release);
+            }
+
+            return count;
+        }
+
+        /**
+         * @brief Dequeues up to max values and frees their slots with a single store.
+         *
+         * @param out Output iterator the values are moved to, e.g. a pointer into an array or a back_inserter
+         * @param max Most values to take
+         * @return How many values were dequeued
+         */
+        template <typename OutputIt>
+        [[nodiscard]] std::size_t TryDequeueBulk(OutputIt out, std::size_t max) noexcept(std::is_nothrow_move_assignable_v<T> &&
+                                                                                         std::is_nothrow_move_constructible_v<T>)
+        {
+            const std::size_t head = m_Head.load(std::memory_order_relaxed);
+            const std::size_t tail = m_Tail.load(std::memory_order_acquire);
+
+            const std::size_t count = std::min(max, tail - head);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                T * value_ptr = SlotPtr(head + i);
+                *out = std::move(*value_ptr);
+                ++out;
+                value_ptr->~T();
+            }
+
+            if (count != 0)
+            {
+                m_Head.store(head + count, std::memory_order_release);
+            }
+
+            return count;
+        }
+
         [[nodiscard]] bool Empty() const noexcept
         {
             return Size() == 0;
@@ -0,0 +1,302 @@
+module;
+
+//import_std
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+export module YT:SpillQueue;
+
+import :MultiProducerMultiConsumer;
+
+namespace YT
+{
+    /// How often a SpillQueue ran out of ring space, for tuning ring capacities
+    export struct SpillQueueStats
+    {
+        std::uint64_t m_Spills = 0;         ///< Items that went to the spill list instead of the ring
+        std::uint64_t m_HighWater = 0;      ///< Most items sitting in the spill list at once
+    };
+
+    /**
+     * @brief Bounded lock-free ring that spills to a linked list of segments instead of failing when full.
+     *
+     * Enqueue always succeeds: while the ring has room it's the ring's lock-free path, once it is full (or anything
+     * is already spilled, to keep rough FIFO order) items go to a mutex guarded list of fixed size segments. Consumers
+     * move spilled items back into the ring as they free up slots, and take straight from the spill list once the
+     * ring runs dry. The spill path allocates a segment at a time, so the ring should be sized so it rarely spills.
+     *
+     * @tparam T Element type. Must be default constructible and nothrow movable.
+     * @tparam Capacity Capacity of the ring
+     * @tparam RingQueue The bounded ring, MultiProducerMultiConsumer or MultiProducerSingleConsumer
+     */
+    export template <typename T, std::size_t Capacity, template <typename, std::size_t> typename RingQueue = MultiProducerMultiConsumer>
+    class SpillQueue
+    {
+        static_assert(std::is_default_constructible_v<T>, "SpillQueue requires a default constructible T");
+        static_assert(std::is_nothrow_move_assignable_v<T>, "SpillQueue requires a nothrow move assignable T");
+
+    public:
+        static constexpr std::size_t SpillSegmentSize = 256;   ///< Items per spill segment
+        static constexpr std::size_t MaxRefillPerDequeue = 16;  ///< Spilled items moved back into the ring per dequeue
+
+        SpillQueue() noexcept = default;
+
+        SpillQueue(const SpillQueue &) = delete;
+        SpillQueue(SpillQueue &&) = delete;
+
+        SpillQueue & operator = (const SpillQueue &) = delete;
+        SpillQueue & operator = (SpillQueue &&) = delete;
+
+        ~SpillQueue() noexcept = default;
+
+        /// Never fails, safe to call from any thread
+        void Enqueue(T && value)
+        {
+            if (m_SpillSize.load(std::memory_order_acquire) == 0 && m_Ring.TryEnqueue(std::move(value)))
+            {
+                return;
+            }
+
+            const std::lock_guard lock(m_SpillMutex);
+
+            // The ring may have drained while we waited for the lock, and with nothing spilled order is safe
+            if (m_SpillSize.load(std::memory_order_relaxed) == 0 && m_Ring.TryEnqueue(std::move(value)))
+            {
+                return;
+            }
+
+            PushSpill(std::move(value));
+        }
+
+        /// Like Enqueue for each value, but fills the ring with one bulk reservation and takes the spill lock at most once
+        void EnqueueBulk(std::span<T> values)
+        {
+            std::size_t enqueued = 0;
+            if (m_SpillSize.load(std::memory_order_acquire) == 0)
+            {
+                enqueued = m_Ring.TryEnqueueBulk(values);
+            }
+
+            if (enqueued == values.size())
+            {
+                return;
+            }
+
+            const std::lock_guard lock(m_SpillMutex);
+
+            if (m_SpillSize.load(std::memory_order_relaxed) == 0)
+            {
+                enqueued += m_Ring.TryEnqueueBulk(values.subspan(enqueued));
+            }
+
+            for (; enqueued < values.size(); ++enqueued)
+            {
+                PushSpill(std::move(values[enqueued]));
+            }
+        }
+
+        /// Takes up to max items from the ring in one go, or a single spilled item once the ring is empty
+        template <typename OutputIt>
+        [[nodiscard]] std::size_t TryDequeueBulk(OutputIt out, std::size_t max) noexcept
+        {
+            if (max == 0)
+            {
+                return 0;
+            }
+
+            const std::size_t count = m_Ring.TryDequeueBulk(out, max);
+            if (count != 0)
+            {
+                if (m_SpillSize.load(std::memory_order_acquire) != 0)
+                {
+                    Refill();
+                }
+
+                return count;
+            }
+
+            T value;
+            if (TryDequeue(value))
+            {
+                *out = std::move(value);
+                return 1;
+            }
+
+            return 0;
+        }
+
+        /// Follows the consumer rules of RingQueue
+        [[nodiscard]] bool TryDequeue(T & out) noexcept
+        {
+            if (m_Ring.TryDequeue(out))
+            {
+                if (m_SpillSize.load(std::memory_order_acquire) != 0)
+                {
+                    Refill();
+                }
+
+                return true;
+            }
+
+            if (m_SpillSize.load(std::memory_order_acquire) == 0)
+            {
+                return false;
+            }
+
+            const std::lock_guard lock(m_SpillMutex);
+
+            // A producer may have slipped into the ring in the meantime, it goes first
+            if (m_Ring.TryDequeue(out))
+            {
+                return true;
+            }
+
+            return PopSpill(out);
+        }
+
+        [[nodiscard]] bool Empty() const noexcept
+        {
+            return m_Ring.Empty() && m_SpillSize.load(std::memory_order_acquire) == 0;
+        }
+
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            return m_Ring.Size() + m_SpillSize.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] std::size_t SpillSize() const noexcept
+        {
+            return m_SpillSize.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] SpillQueueStats GetStats() const noexcept
+        {
+            return SpillQueueStats
+            {
+                .m_Spills = m_Spills.load(std::memory_order_relaxed),
+                .m_HighWater = m_HighWater.load(std::memory_order_relaxed),
+            };
+        }
+
+        static consteval std::size_t RingCapacity() noexcept
+        {
+            return Capacity;
+        }
+
+    private:
+        struct Segment
+        {
+            std::array<T, SpillSegmentSize> m_Items = {};
+            std::size_t m_Begin = 0;
+            std::size_t m_End = 0;
+            std::unique_ptr<Segment> m_Next;
+        };
+
+        /// Call with m_SpillMutex held
+        void PushSpill(T && value)
+        {
+            if (!m_Tail || m_Tail->m_End == SpillSegmentSize)
+            {
+                std::unique_ptr<Segment> segment = m_SpareSegment ? std::move(m_SpareSegment) : std::make_unique<Segment>();
+                Segment * const segment_ptr = segment.get();
+
+                if (m_Tail)
+                {
+                    m_Tail->m_Next = std::move(segment);
+                }
+                else
+                {
+                    m_Head = std::move(segment);
+                }
+
+                m_Tail = segment_ptr;
+            }
+
+            m_Tail->m_Items[m_Tail->m_End++] = std::move(value);
+
+            const std::size_t spill_size = m_SpillSize.load(std::memory_order_relaxed) + 1;
+            m_SpillSize.store(spill_size, std::memory_order_release);
+
+            m_Spills.fetch_add(1, std::memory_order_relaxed);
+            if (spill_size > m_HighWater.load(std::memory_order_relaxed))
+            {
+                m_HighWater.store(spill_size, std::memory_order_relaxed);
+            }
+        }
+
+        /// Call with m_SpillMutex held
+        [[nodiscard]] bool PopSpill(T & out) noexcept
+        {
+            if (m_SpillSize.load(std::memory_order_relaxed) == 0)
+            {
+                return false;
+            }
+
+            Segment & head = *m_Head;
+            out = std::move(head.m_Items[head.m_Begin++]);
+
+            if (head.m_Begin == head.m_End)
+            {
+                if (m_Head.get() == m_Tail)
+                {
+                    // Last segment, keep it around for the next spill
+                    head.m_Begin = 0;
+                    head.m_End = 0;
+                }
+                else
+                {
+                    std::unique_ptr<Segment> finished = std::exchange(m_Head, std::move(head.m_Next));
+                    finished->m_Begin = 0;
+                    finished->m_End = 0;
+                    m_SpareSegment = std::move(finished);
+                }
+            }
+
+            m_SpillSize.store(m_SpillSize.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Moves spilled items back into the ring now that a slot has freed up
+        void Refill() noexcept
+        {
+            std::unique_lock lock(m_SpillMutex, std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                // Someone else is spilling or refilling, they'll get to it
+                return;
+            }
+
+            for (std::size_t i = 0; i < MaxRefillPerDequeue && m_SpillSize.load(std::memory_order_relaxed) != 0; ++i)
+            {
+                Segment & head = *m_Head;
+                if (!m_Ring.TryEnqueue(std::move(head.m_Items[head.m_Begin])))
+                {
+                    break;
+                }
+
+                T discard;
+                [[maybe_unused]] const bool popped = PopSpill(discard);
+            }
+        }
+
+    private:
+        RingQueue<T, Capacity> m_Ring;
+
+        alignas(64) std::mutex m_SpillMutex;
+        std::unique_ptr<Segment> m_Head;
+        Segment * m_Tail = nullptr;
+        std::unique_ptr<Segment> m_SpareSegment;
+
+        alignas(64) std::atomic<std::size_t> m_SpillSize = 0;
+        std::atomic<std::uint64_t> m_Spills = 0;
+        std::atomic<std::uint64_t> m_HighWater = 0;
+    };
+}
@@ -0,0 +1,143 @@
+module;
+
+//import_std
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+export module YT:WorkStealingDeque;
+
+namespace YT
+{
+    /**
+     * @brief Fixed-capacity Chase-Lev work-stealing deque.
+     *
+     * The owning thread pushes and pops at the bottom (LIFO, keeps hot work in cache) while any number of
+     * thief threads steal from the top (FIFO, takes the oldest and usually largest work first).
+     * Memory ordering follows Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+     *
+     * @tparam T Element type. Must be trivially copyable since slots are read speculatively by thieves.
+     * @tparam Capacity Maximum number of elements. Must be a power of two.
+     */
+    export template <typename T, std::size_t Capacity>
+    class WorkStealingDeque
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "WorkStealingDeque requires a power of two Capacity");
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque requires a trivially copyable T");
+
+    public:
+        WorkStealingDeque() noexcept = default;
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque(WorkStealingDeque &&) = delete;
+
+        WorkStealingDeque & operator = (const WorkStealingDeque &) = delete;
+        WorkStealingDeque & operator = (WorkStealingDeque &&) = delete;
+
+        ~WorkStealingDeque() noexcept = default;
+
+        /// Call from the owning thread only.
+        [[nodiscard]] bool Push(T value) noexcept
+        {
+            const std::int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+            const std::int64_t top = m_Top.load(std::memory_order_acquire);
+
+            if (bottom - top >= static_cast<std::int64_t>(Capacity))
+            {
+                return false;
+            }
+
+            SlotAt(bottom).store(value, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /// Call from the owning thread only.
+        [[nodiscard]] bool Pop(T & out) noexcept
+        {
+            const std::int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+            m_Bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = m_Top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                // Already empty, restore the bottom
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            T value = SlotAt(bottom).load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last element, race the thieves for it
+                const bool won = m_Top.compare_exchange_strong(top, top + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed);
+
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                if (!won)
+                {
+                    return false;
+                }
+            }
+
+            out = value;
+            return true;
+        }
+
+        /// Safe to call from any thread.
+        [[nodiscard]] bool Steal(T & out) noexcept
+        {
+            std::int64_t top = m_Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+            {
+                return false;
+            }
+
+            T value = SlotAt(top).load(std::memory_order_relaxed);
+            if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                // Lost the race against the owner or another thief
+                return false;
+            }
+
+            out = value;
+            return true;
+        }
+
+        [[nodiscard]] bool Empty() const noexcept
+        {
+            return Size() == 0;
+        }
+
+        [[nodiscard]] std::size_t Size() const noexcept
+        {
+            const std::int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+            const std::int64_t top = m_Top.load(std::memory_order_acquire);
+            return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+        }
+
+        static consteval std::size_t MaxSize() noexcept
+        {
+            return Capacity;
+        }
+
+    private:
+        [[nodiscard]] std::atomic<T> & SlotAt(std::int64_t index) noexcept
+        {
+            return m_Slots[static_cast<std::size_t>(index) & (Capacity - 1)];
+        }
+
+    private:
+        alignas(64) std::atomic<std::int64_t> m_Top = 0;
+        alignas(64) std::atomic<std::int64_t> m_Bottom = 0;
+        alignas(64) std::array<std::atomic<T>, Capacity> m_Slots = {};
+    };
+}
@@ -13,6 +13,7 @@ import :Types;
 import :ImageReference;
 import :ImageLoad;
 import :Coroutine;
+import :Cancellation;
 import :FileMapper;
 
 namespace YT
@@ -27,6 +28,9 @@ namespace YT
         explicit DeferredImageLoad(const Span<const std::byte> & image_data) noexcept;
         explicit DeferredImageLoad(const StringView & file_name) noexcept;
 
+        /// Cancels the load if it is still running, its result is dropped instead of written back
+        ~DeferredImageLoad() noexcept;
+
         DeferredImageLoad(const DeferredImageLoad &) = delete;
         DeferredImageLoad(DeferredImageLoad &&) = delete;
         DeferredImageLoad & operator=(const DeferredImageLoad &) = delete;
@@ -37,6 +41,8 @@ namespace YT
         const ImageReference & operator * () const noexcept;
 
         static void Start() noexcept;
+        /// Blocks until every load started since Start is done. Waits like CoroBundle::WaitForCompletion, so it
+        /// never parks and keeps the main thread's core busy on CPUs without umwait/mwaitx.
         static void Finalize() noexcept;
 
     protected:
@@ -51,6 +57,7 @@ namespace YT
 
         Optional<ImageLoadInfo> m_ImageLoadInfo;
         ImageReference m_ImageRef;
+        CancellationSource m_Cancellation;
 
         DeferredImageLoad * m_Next = nullptr;
     };
@@ -23,6 +23,7 @@ import :DeferredImageLoad;
 import :RenderManager;
 import :FileMapper;
 import :Coroutine;
+import :Cancellation;
 
 namespace YT
 {
@@ -42,6 +43,21 @@ namespace YT
         g_DeferredImageLoadHead = this;
     }
 
+    DeferredImageLoad::~DeferredImageLoad() noexcept
+    {
+        // Not started yet, just leave the pending list
+        for (DeferredImageLoad ** link = &g_DeferredImageLoadHead; *link != nullptr; link = &(*link)->m_Next)
+        {
+            if (*link == this)
+            {
+                *link = m_Next;
+                break;
+            }
+        }
+
+        m_Cancellation.Cancel();
+    }
+
     DeferredImageLoad::operator const ImageReference & () const noexcept
     {
         return m_ImageRef;
@@ -78,7 +94,7 @@ namespace YT
 
         for (DeferredImageLoad * ptr : deferred_images)
         {
-            loads->PushJob(ptr->AsyncLoad());
+            loads->PushJob(ptr->AsyncLoad().WithCancellation(ptr->m_Cancellation.GetToken()));
         }
 
         g_DeferredImageLoadBundles.emplace_back(std::move(loads));
@@ -98,16 +114,27 @@ namespace YT
 
     Coro<void, ThreadContextType::AnyThread> DeferredImageLoad::AsyncLoad()
     {
-        if (m_ImageData.data())
+        // Our own copies, this DeferredImageLoad may be destroyed while we're suspended
+        const CancellationToken token = co_await CurrentCancellationToken();
+        const Span<const std::byte> image_data = m_ImageData;
+        const String file_name = m_FileName;
+
+        ImageReference reference;
+        if (image_data.data())
         {
-            m_ImageRef = co_await LoadImageFromMemory(m_ImageData);
+            reference = co_await LoadImageFromMemory(image_data);
         }
         else
         {
-            ImageReference reference = co_await LoadImageFromFile(m_FileName);
-            m_ImageRef = std::move(reference);
+            reference = co_await LoadImageFromFile(file_name);
+        }
+
+        // We resume on the main thread after the load, the same thread the destructor cancels from
+        if (token.IsCancellationRequested())
+        {
+            co_return;
         }
 
-        co_return;
+        m_ImageRef = std::move(reference);
     }
 }
@@ -4,6 +4,7 @@ module;
 #include <cstddef>
 #include <coroutine>
 #include <new>
+#include <tuple>
 
 #include <stb_image.h>
 
@@ -12,6 +13,8 @@ module YT:ImageLoadImpl;
 import :ImageLoad;
 import :Types;
 import :Coroutine;
+import :Cancellation;
+import :CoroCombinators;
 import :FileMapper;
 import :RenderManager;
 
@@ -61,6 +64,13 @@ namespace YT
     BackgroundTask<ImageLoadInfo> DecodeImageFileAsync(const StringView & file_name) noexcept
     {
         MappedFile file = co_await MapFileAsync(file_name);
+
+        // Nobody wants the image anymore, drop the mapping without decoding
+        if ((co_await CurrentCancellationToken()).IsCancellationRequested())
+        {
+            co_return ImageLoadInfo{};
+        }
+
         co_return DecodeImage(file.GetData());
     }
 
@@ -77,17 +87,46 @@ namespace YT
         return {};
     }
 
-    MainThreadTask<ImageReference> LoadImageFromMemory(const Span<const std::byte> & image_data) noexcept
+    MainThreadTask<void> WaitForImageGenerationReady() noexcept
     {
-        ImageLoadInfo load_info = co_await DecodeImageAsync(image_data);
         co_await CoroEventWait(g_RenderManager->GetImageGenerationReadyEvent());
-        co_return CreateImage(load_info);
+    }
+
+    MainThreadTask<ImageReference> LoadImageFromMemory(const Span<const std::byte> & image_data) noexcept
+    {
+        // WhenAll starts its children even when cancelled, so don't kick off the decode or the render wait at all
+        if ((co_await CurrentCancellationToken()).IsCancellationRequested())
+        {
+            co_return ImageReference{};
+        }
+
+        // Decode while the render manager is still getting ready to create images
+        auto results = co_await WhenAll(DecodeImageAsync(image_data), WaitForImageGenerationReady());
+
+        // Skip the staging upload if the load was cancelled, the decoded pixels are freed on the way out
+        if ((co_await CurrentCancellationToken()).IsCancellationRequested())
+        {
+            co_return ImageReference{};
+        }
+
+        co_return CreateImage(std::get<0>(results));
     }
 
     MainThreadTask<ImageReference> LoadImageFromFile(const StringView & file_name) noexcept
     {
-        ImageLoadInfo load_info = co_await DecodeImageFileAsync(file_name);
-        co_await CoroEventWait(g_RenderManager->GetImageGenerationReadyEvent());
-        co_return CreateImage(load_info);
+        // Already cancelled, don't map the file or wait on the render manager
+        if ((co_await CurrentCancellationToken()).IsCancellationRequested())
+        {
+            co_return ImageReference{};
+        }
+
+        auto results = co_await WhenAll(DecodeImageFileAsync(file_name), WaitForImageGenerationReady());
+
+        if ((co_await CurrentCancellationToken()).IsCancellationRequested())
+        {
+            co_return ImageReference{};
+        }
+
+        co_return CreateImage(std::get<0>(results));
     }
 }
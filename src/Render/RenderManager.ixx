@@ -15,6 +15,8 @@ module;
 #include <chrono>
 #include <any>
 #include <mutex>
+#include <semaphore>
+#include <thread>
 #include <type_traits>
 
 #define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
@@ -87,6 +89,12 @@ namespace YT
         bool RenderWindowResources(const Vector<WindowResource*> & window_resources) noexcept;
         void ReleaseWindowResource(WindowResource & resource) noexcept;
 
+        /// Blocks until the previous frame's pipelined submit and present have finished, returns straight away otherwise
+        void WaitForFrameSubmit() const noexcept;
+
+        /// CPU side view of how far behind the GPU is running, see FrameLatencyStats
+        [[nodiscard]] const FrameLatencyStats & GetFrameLatencyStats() const noexcept { return m_FrameLatencyStats; }
+
         void CleanupImmediately();
 
         void RegisterShader(const std::uint8_t* shader_data, std::size_t shader_data_size) noexcept;
@@ -164,12 +172,24 @@ namespace YT
         bool UpdateBufferDescriptorSetInfo() noexcept;
         [[nodiscard]] OptionalPtr<PSOVariant> PreparePSO(const PSODeferredSettings & deferred_settings, PSO & pso) noexcept;
 
+        /// Records the window's widgets into its secondary command buffer, needs neither the queue nor the swap chain image
+        bool RecordWindowContents(WindowResource & resource) noexcept;
         bool PrepareCommandBufferForPresent(const WindowResource & resource) noexcept;
         bool CompleteCommandBufferForPresent(const WindowResource & resource) noexcept;
         bool PresentWindow(const WindowResource & resource) noexcept;
 
         bool SubmitImageUploadCommandBuffer() noexcept;
 
+        /// Waits until reusing the current frame resource keeps at most max_frames_in_flight frames queued on the GPU
+        [[nodiscard]] std::uint64_t WaitForFrameResource(std::uint64_t max_frames_in_flight) noexcept;
+
+        /// Submits and presents m_PendingSubmit, on the main thread or the submit thread in pipelined mode. The caller
+        /// signals AfterPresent on the main thread once it returns.
+        bool SubmitFrame() noexcept;
+
+        /// Pipelined mode only, runs SubmitFrame each time the main thread hands over m_PendingSubmit
+        void RunSubmitThread() noexcept;
+
         std::uint64_t AllocateTimelineSemaphoreValue() noexcept;
 
     private:
@@ -252,6 +272,9 @@ namespace YT
             vk::UniqueCommandBuffer m_CommandBuffer;
 
             vk::DescriptorSet m_BufferDescriptorSet;
+
+            std::uint64_t m_TimelineValue = 0;      ///< Frame semaphore value signalled when the GPU is done with this resource
+            std::chrono::time_point<std::chrono::steady_clock> m_RecordStartTime;
         };
 
         static constexpr int FrameResourceCount = 3;
@@ -260,6 +283,30 @@ namespace YT
 
         vk::UniqueSemaphore m_FrameSemaphore;
 
+        // Frame pipelining
+        struct PendingSubmit
+        {
+            Vector<WindowResource*> m_WindowResources;
+            Vector<vk::CommandBufferSubmitInfo> m_CommandBufferSubmitInfos;
+            Vector<vk::SemaphoreSubmitInfo> m_WaitSemaphoreInfos;
+            Vector<vk::SemaphoreSubmitInfo> m_SignalSemaphoreInfos;
+        };
+
+        bool m_PipelinedFrames = false;
+        std::uint64_t m_MaxFramesInFlight = 2;
+
+        /// Only touched by the main thread while no submit is in flight, and by the submitting thread while one is
+        PendingSubmit m_PendingSubmit;
+        std::atomic_bool m_SubmitInFlight = false;
+        std::atomic_bool m_SubmitFailed = false;        ///< Set by the submit thread, reported by the next RenderWindowResources
+        bool m_AfterPresentPending = false;             ///< Main thread only, the submit thread presented a frame nobody has signalled yet
+
+        std::atomic_bool m_SubmitThreadRunning = false;
+        std::binary_semaphore m_SubmitThreadSignal{0};
+        Thread m_SubmitThread;
+
+        FrameLatencyStats m_FrameLatencyStats;
+
         UniquePtr<TransferManager> m_TransferManager;
 
         // Deletion data
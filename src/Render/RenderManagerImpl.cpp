@@ -11,10 +11,12 @@ module;
 #include <functional>
 #include <any>
 #include <algorithm>
+#include <utility>
 #include <mutex>
 #include <atomic>
 #include <chrono>
 #include <ratio>
+#include <thread>
 #include <format>
 #include <iostream>
 
@@ -47,6 +49,8 @@ import :FontManager;
 import :FileMapper;
 import :Drawer;
 import :BackgroundTaskManager;
+import :FrameTiming;
+import :Wait;
 
 VKAPI_ATTR static VkBool32 VKAPI_CALL DebugMessageFunc(
     vk::DebugUtilsMessageSeverityFlagBitsEXT message_severity,
@@ -145,6 +149,16 @@ namespace YT
 
             m_StartTime = std::chrono::steady_clock::now();
             m_LastRenderTime = m_StartTime;
+
+            // Deterministic runs keep everything on the main thread so a frame can't overlap the next one
+            m_PipelinedFrames = init_info.m_PipelinedFrames && !Threading::IsDeterministicScheduling();
+            m_MaxFramesInFlight = std::clamp<std::uint64_t>(init_info.m_MaxFramesInFlight, 1, FrameResourceCount);
+
+            if (m_PipelinedFrames)
+            {
+                m_SubmitThreadRunning = true;
+                m_SubmitThread = std::thread(&RenderManager::RunSubmitThread, this);
+            }
         }
         catch (vk::SystemError& err)
         {
@@ -162,6 +176,13 @@ namespace YT
 
         CleanupImmediately();
 
+        if (m_SubmitThread.joinable())
+        {
+            m_SubmitThreadRunning.store(false, std::memory_order_release);
+            m_SubmitThreadSignal.release();
+            m_SubmitThread.join();
+        }
+
         m_PSOTable.Clear();
 
         for (auto & frame_resource : m_FrameResources)
@@ -626,6 +647,9 @@ namespace YT
 
             resource.m_CommandBuffers = m_Device->allocateCommandBuffersUnique(allocate_info);
 
+            allocate_info.level = vk::CommandBufferLevel::eSecondary;
+            resource.m_ContentCommandBuffers = m_Device->allocateCommandBuffersUnique(allocate_info);
+
             return true;
         }
         catch (vk::SystemError& err)
@@ -671,20 +695,25 @@ namespace YT
 
     bool RenderManager::RenderWindowResources(const Vector<WindowResource*> & window_resources) noexcept
     {
-        SubmitImageUploadCommandBuffer();
+        AdvanceFrameTimers();
 
         FrameResource & frame_resource = m_FrameResources[m_FrameIndex];
 
         vk::Result result = vk::Result::eSuccess;
 
-        std::uint64_t current_frame_semaphore_value = 0;
-        result = m_Device->getSemaphoreCounterValue(m_FrameSemaphore.get(), &current_frame_semaphore_value);
-
-        if (result != vk::Result::eSuccess)
+        // A window's command buffers cycle over its swap chain images, so never queue more frames than the smallest
+        // swap chain has images or we would re-record buffers the GPU hasn't finished with
+        std::uint64_t max_frames_in_flight = m_MaxFramesInFlight;
+        for (const WindowResource * resource_ptr : window_resources)
         {
-            FatalPrint("Failed to get semaphore counter value");
+            if (!resource_ptr->m_SwapChainImages.empty())
+            {
+                max_frames_in_flight = std::min<std::uint64_t>(max_frames_in_flight, resource_ptr->m_SwapChainImages.size());
+            }
         }
 
+        const std::uint64_t current_frame_semaphore_value = WaitForFrameResource(max_frames_in_flight);
+
         m_PreRenderDelegate.Execute();
 
         if (!UpdateBufferDescriptorSetInfo())
@@ -702,6 +731,8 @@ namespace YT
         std::chrono::duration<double, std::milli> elapsed_since_start = now - m_StartTime;
         std::chrono::duration<double, std::milli> elapsed_since_last_render = now - m_LastRenderTime;
 
+        frame_resource.m_RecordStartTime = now;
+
         GlobalData global_data;
         global_data.m_Time = static_cast<float>(elapsed_since_start.count() / 1000.0);
         global_data.m_DeltaTime = static_cast<float>(elapsed_since_last_render.count() / 1000.0);
@@ -712,6 +743,8 @@ namespace YT
 
         m_LastRenderTime = now;
 
+        // Record the widgets first. This only touches our own command buffers and transient buffers, so in pipelined
+        // mode it overlaps the previous frame's submit and present.
         for (WindowResource * resource_ptr : window_resources)
         {
             WindowResource & resource = *resource_ptr;
@@ -725,73 +758,102 @@ namespace YT
 
             if (resource.m_Widget)
             {
-                try
+                if (!RecordWindowContents(resource))
                 {
-                    if (resource.m_RequestedExtent != resource.m_SwapChainExtent)
-                    {
-                        VerbosePrint(LogType::RenderManager, "Recreating swap chain due to requested size change");
-                        if (!UpdateWindowResource(resource))
-                        {
-                            FatalPrint("Failed to update swap chain due to requested size");
-                            return false;
-                        }
-                    }
+                    return false;
+                }
 
-                    result = m_Device->acquireNextImageKHR(resource.m_SwapChain.get(), UINT64_MAX,
-                            resource.m_ImageAvailableSemaphores[resource.m_FrameIndex].get(), {}, &resource.m_SwapChainImageIndex);
+                resource.m_WasRenderedThisFrame = true;
+            }
+        }
 
-                    while (result == vk::Result::eSuboptimalKHR || result == vk::Result::eErrorOutOfDateKHR)
-                    {
-                        VerbosePrint(LogType::RenderManager, "Recreating swap chain due to vulkan response");
-                        if (!UpdateWindowResource(resource))
-                        {
-                            FatalPrint("Failed to update swap chain due to vulkan response");
-                            return false;
-                        }
+        // From here on we need the queue and the swap chains, which the previous frame owns until its present returns
+        WaitForFrameSubmit();
 
-                        result = m_Device->acquireNextImageKHR(resource.m_SwapChain.get(), UINT64_MAX,
-                                resource.m_ImageAvailableSemaphores[resource.m_FrameIndex].get(), {}, &resource.m_SwapChainImageIndex);
-                    }
+        if (m_SubmitFailed.exchange(false, std::memory_order_relaxed))
+        {
+            FatalPrint("Previous frame failed to submit");
+            return false;
+        }
 
-                    if (!PrepareCommandBufferForPresent(resource))
+        // Signalled here rather than on the submit thread, AfterPresent waiters may resume inline and need a job context
+        if (std::exchange(m_AfterPresentPending, false))
+        {
+            SignalAfterPresent();
+        }
+
+        SubmitImageUploadCommandBuffer();
+
+        for (WindowResource * resource_ptr : window_resources)
+        {
+            WindowResource & resource = *resource_ptr;
+            if (!resource.m_WasRenderedThisFrame)
+            {
+                continue;
+            }
+
+            try
+            {
+                if (resource.m_RequestedExtent != resource.m_SwapChainExtent)
+                {
+                    VerbosePrint(LogType::RenderManager, "Recreating swap chain due to requested size change");
+                    if (!UpdateWindowResource(resource))
                     {
-                        FatalPrint("Failed to prepare command buffer");
+                        FatalPrint("Failed to update swap chain due to requested size");
                         return false;
                     }
+                }
 
-                    DrawerData drawer_data;
-                    drawer_data.m_ViewportSize = glm::vec2(resource_ptr->m_SwapChainExtent.width, resource_ptr->m_SwapChainExtent.height);
-                    drawer_data.m_Size = drawer_data.m_ViewportSize;
-                    drawer_data.m_Offset = glm::vec2(0.0f);
-
-                    PSODeferredSettings pso_deferred_settings;
-                    pso_deferred_settings.m_SurfaceFormat = resource.m_SwapChainFormat;
-                    pso_deferred_settings.m_BufferDescriptorSetId = m_BufferDescriptorSetId;
+                result = m_Device->acquireNextImageKHR(resource.m_SwapChain.get(), UINT64_MAX,
+                        resource.m_ImageAvailableSemaphores[resource.m_FrameIndex].get(), {}, &resource.m_SwapChainImageIndex);
 
-                    Drawer drawer(resource.m_CommandBuffers[resource.m_FrameIndex].get(), drawer_data, pso_deferred_settings);
-                    resource.m_Widget->OnDraw(drawer);
+                while (result == vk::Result::eSuboptimalKHR || result == vk::Result::eErrorOutOfDateKHR)
+                {
+                    VerbosePrint(LogType::RenderManager, "Recreating swap chain due to vulkan response");
+                    if (!UpdateWindowResource(resource))
+                    {
+                        FatalPrint("Failed to update swap chain due to vulkan response");
+                        return false;
+                    }
 
-                    drawer.Flush();
+                    result = m_Device->acquireNextImageKHR(resource.m_SwapChain.get(), UINT64_MAX,
+                            resource.m_ImageAvailableSemaphores[resource.m_FrameIndex].get(), {}, &resource.m_SwapChainImageIndex);
+                }
 
-                    if (!CompleteCommandBufferForPresent(resource))
+                // The widgets were recorded against the old swap chain, redraw them to fit the new one
+                if (resource.m_ContentExtent != resource.m_SwapChainExtent || resource.m_ContentFormat != resource.m_SwapChainFormat)
+                {
+                    if (!RecordWindowContents(resource))
                     {
-                        FatalPrint("Failed to complete command buffer");
                         return false;
                     }
-
-                    resource.m_WasRenderedThisFrame = true;
                 }
-                catch (vk::SystemError& err)
+
+                if (!PrepareCommandBufferForPresent(resource))
                 {
-                    FatalPrint("Failed to render window: {}", err.what());
+                    FatalPrint("Failed to prepare command buffer");
                     return false;
                 }
-                catch (...)
+
+                resource.m_CommandBuffers[resource.m_FrameIndex]->executeCommands(
+                    resource.m_ContentCommandBuffers[resource.m_FrameIndex].get());
+
+                if (!CompleteCommandBufferForPresent(resource))
                 {
-                    FatalPrint("Failed to render window: unknown exception");
+                    FatalPrint("Failed to complete command buffer");
                     return false;
                 }
             }
+            catch (vk::SystemError& err)
+            {
+                FatalPrint("Failed to render window: {}", err.what());
+                return false;
+            }
+            catch (...)
+            {
+                FatalPrint("Failed to render window: unknown exception");
+                return false;
+            }
         }
 
         // Finalize buffers
@@ -800,18 +862,21 @@ namespace YT
             buffer->End();
         }
 
-        // Submit everything
-        Vector<vk::CommandBufferSubmitInfo> command_buffer_submit_infos;
-        Vector<vk::SemaphoreSubmitInfo> image_avail_semaphore_wait_infos;
-        Vector<vk::SemaphoreSubmitInfo> render_finished_semaphore_signal_infos;
+        // Gather everything to submit
+        m_PendingSubmit.m_WindowResources.clear();
+        m_PendingSubmit.m_CommandBufferSubmitInfos.clear();
+        m_PendingSubmit.m_WaitSemaphoreInfos.clear();
+        m_PendingSubmit.m_SignalSemaphoreInfos.clear();
 
         for (WindowResource * resource_ptr : window_resources)
         {
             WindowResource & resource = *resource_ptr;
             if (resource.m_WasRenderedThisFrame)
             {
+                m_PendingSubmit.m_WindowResources.push_back(resource_ptr);
+
                 vk::SemaphoreSubmitInfo & image_avail_submit_info =
-                    image_avail_semaphore_wait_infos.emplace_back();
+                    m_PendingSubmit.m_WaitSemaphoreInfos.emplace_back();
 
                 image_avail_submit_info.setSemaphore(
                     resource.m_ImageAvailableSemaphores[resource.m_FrameIndex].get());
@@ -819,57 +884,52 @@ namespace YT
                     vk::PipelineStageFlagBits2::eColorAttachmentOutput);
 
                 vk::SemaphoreSubmitInfo & render_finished_submit_info =
-                    render_finished_semaphore_signal_infos.emplace_back();
+                    m_PendingSubmit.m_SignalSemaphoreInfos.emplace_back();
 
                 render_finished_submit_info.setSemaphore(
                     resource.m_RenderFinishedSemaphores[resource.m_SwapChainImageIndex].get());
                 render_finished_submit_info.setStageMask(
                     vk::PipelineStageFlagBits2::eColorAttachmentOutput);
 
-                command_buffer_submit_infos.emplace_back(
+                m_PendingSubmit.m_CommandBufferSubmitInfos.emplace_back(
                     resource.m_CommandBuffers[resource.m_FrameIndex].get());
+
+                // Advanced here rather than after present so the next frame can record while this one presents
+                resource.m_FrameIndex++;
+                if (resource.m_FrameIndex >= resource.m_SwapChainImages.size())
+                {
+                    resource.m_FrameIndex = 0;
+                }
             }
         }
 
+        frame_resource.m_TimelineValue = GPendingFrameTimelineValue;
+
         vk::SemaphoreSubmitInfo & timeline_submit_info =
-            render_finished_semaphore_signal_infos.emplace_back();
+            m_PendingSubmit.m_SignalSemaphoreInfos.emplace_back();
         timeline_submit_info.setSemaphore(m_FrameSemaphore.get());
-        timeline_submit_info.setValue(GPendingFrameTimelineValue);
+        timeline_submit_info.setValue(frame_resource.m_TimelineValue);
         timeline_submit_info.setStageMask(vk::PipelineStageFlagBits2::eAllGraphics);
 
-        vk::SubmitInfo2 submit_info;
-        submit_info.setWaitSemaphoreInfos(image_avail_semaphore_wait_infos);
-        submit_info.setCommandBufferInfos(command_buffer_submit_infos);
-        submit_info.setSignalSemaphoreInfos(render_finished_semaphore_signal_infos);
+        if (m_PipelinedFrames)
+        {
+            // Present can block until vblank, hand it to the submit thread while we get on with the next frame
+            m_SubmitInFlight.store(true, std::memory_order_relaxed);
+            m_AfterPresentPending = true;
+            m_SubmitThreadSignal.release();
+        }
+        else if (SubmitFrame())
+        {
+            SignalAfterPresent();
+        }
+        else
+        {
+            return false;
+        }
 
         try
         {
-            result = m_Queue.submit2(1, &submit_info, vk::Fence());
-            if (result != vk::Result::eSuccess)
-            {
-                FatalPrint("Failed to submit command buffer submission: {}", vk::to_string(result));
-                return false;
-            }
-
-            for (WindowResource * resource_ptr : window_resources)
-            {
-                WindowResource & resource = *resource_ptr;
-                if (resource.m_WasRenderedThisFrame)
-                {
-                    if (!PresentWindow(resource))
-                    {
-                        FatalPrint("Failed to submit command buffer");
-                        return false;
-                    }
-
-                    resource.m_FrameIndex++;
-                    if (resource.m_FrameIndex >= resource.m_SwapChainImages.size())
-                    {
-                        resource.m_FrameIndex = 0;
-                    }
-                }
-            }
-            // Do any queued deletes for last frame
+            // Do any queued deletes for frames the GPU has finished with
             while (!m_DeferredDeleteInfos.empty())
             {
                 const DeferredDeleteInfo & delete_info = m_DeferredDeleteInfos.front();
@@ -890,14 +950,9 @@ namespace YT
 
             }
         }
-        catch (vk::SystemError& err)
-        {
-            FatalPrint("Failed to submit window: {}", err.what());
-            return false;
-        }
         catch (...)
         {
-            FatalPrint("Failed to submit window: unknown exception");
+            FatalPrint("Failed to run deferred delete: unknown exception");
             return false;
         }
 
@@ -913,8 +968,137 @@ namespace YT
         return true;
     }
 
+    bool RenderManager::SubmitFrame() noexcept
+    {
+        vk::SubmitInfo2 submit_info;
+        submit_info.setWaitSemaphoreInfos(m_PendingSubmit.m_WaitSemaphoreInfos);
+        submit_info.setCommandBufferInfos(m_PendingSubmit.m_CommandBufferSubmitInfos);
+        submit_info.setSignalSemaphoreInfos(m_PendingSubmit.m_SignalSemaphoreInfos);
+
+        try
+        {
+            vk::Result result = m_Queue.submit2(1, &submit_info, vk::Fence());
+            if (result != vk::Result::eSuccess)
+            {
+                FatalPrint("Failed to submit command buffer submission: {}", vk::to_string(result));
+                return false;
+            }
+
+            for (WindowResource * resource_ptr : m_PendingSubmit.m_WindowResources)
+            {
+                WindowResource & resource = *resource_ptr;
+                if (!PresentWindow(resource))
+                {
+                    FatalPrint("Failed to submit command buffer");
+                    return false;
+                }
+            }
+        }
+        catch (vk::SystemError& err)
+        {
+            FatalPrint("Failed to submit window: {}", err.what());
+            return false;
+        }
+        catch (...)
+        {
+            FatalPrint("Failed to submit window: unknown exception");
+            return false;
+        }
+
+        return true;
+    }
+
+    void RenderManager::WaitForFrameSubmit() const noexcept
+    {
+        while (m_SubmitInFlight.load(std::memory_order_acquire))
+        {
+            AtomicWait(m_SubmitInFlight, true);
+        }
+    }
+
+    void RenderManager::RunSubmitThread() noexcept
+    {
+        while (true)
+        {
+            m_SubmitThreadSignal.acquire();
+
+            if (!m_SubmitThreadRunning.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            if (!SubmitFrame())
+            {
+                m_SubmitFailed.store(true, std::memory_order_relaxed);
+            }
+
+            m_SubmitInFlight.store(false, std::memory_order_release);
+            AtomicNotify(m_SubmitInFlight);
+        }
+    }
+
+    std::uint64_t RenderManager::WaitForFrameResource(std::uint64_t max_frames_in_flight) noexcept
+    {
+        FrameResource & frame_resource = m_FrameResources[m_FrameIndex];
+
+        // Frames are one timeline value apart, so this keeps at most max_frames_in_flight on the GPU once we submit.
+        // It is never lower than the last use of this frame resource, whose transient buffers we're about to rewrite.
+        const std::uint64_t pending_value = GPendingFrameTimelineValue;
+        const std::uint64_t max_in_flight_value = pending_value > max_frames_in_flight ? pending_value - max_frames_in_flight : 0;
+        const std::uint64_t wait_value = std::max(max_in_flight_value, frame_resource.m_TimelineValue);
+
+        std::uint64_t current_frame_semaphore_value = 0;
+        vk::Result result = m_Device->getSemaphoreCounterValue(m_FrameSemaphore.get(), &current_frame_semaphore_value);
+
+        if (result != vk::Result::eSuccess)
+        {
+            FatalPrint("Failed to get semaphore counter value");
+        }
+
+        if (current_frame_semaphore_value < wait_value)
+        {
+            const vk::Semaphore frame_semaphore = m_FrameSemaphore.get();
+
+            vk::SemaphoreWaitInfo wait_info;
+            wait_info.setSemaphores(frame_semaphore);
+            wait_info.setValues(wait_value);
+
+            result = m_Device->waitSemaphores(&wait_info, UINT64_MAX);
+            if (result != vk::Result::eSuccess)
+            {
+                FatalPrint("Failed to wait for frame semaphore: {}", vk::to_string(result));
+            }
+
+            current_frame_semaphore_value = wait_value;
+        }
+
+        // Any frame the GPU has finished since last time gets its latency measured, once
+        const auto now = std::chrono::steady_clock::now();
+        for (FrameResource & finished_resource : m_FrameResources)
+        {
+            if (finished_resource.m_TimelineValue == 0 || finished_resource.m_TimelineValue > current_frame_semaphore_value)
+            {
+                continue;
+            }
+
+            const std::uint64_t latency_us = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - finished_resource.m_RecordStartTime).count());
+
+            m_FrameLatencyStats.m_NumFrames++;
+            m_FrameLatencyStats.m_LastLatencyUs = latency_us;
+            m_FrameLatencyStats.m_MaxLatencyUs = std::max(m_FrameLatencyStats.m_MaxLatencyUs, latency_us);
+            m_FrameLatencyStats.m_TotalLatencyUs += latency_us;
+
+            finished_resource.m_TimelineValue = 0;
+        }
+
+        return current_frame_semaphore_value;
+    }
+
     void RenderManager::ReleaseWindowResource(WindowResource & resource) noexcept
     {
+        WaitForFrameSubmit();
+
         for (auto & semaphore : resource.m_ImageAvailableSemaphores)
         {
             PushDeferredDeleteObject(GPendingFrameTimelineValue, std::move(semaphore));
@@ -935,6 +1119,11 @@ namespace YT
             PushDeferredDeleteObject(GPendingFrameTimelineValue, std::move(command_buffer));
         }
 
+        for (auto & command_buffer : resource.m_ContentCommandBuffers)
+        {
+            PushDeferredDeleteObject(GPendingFrameTimelineValue, std::move(command_buffer));
+        }
+
         PushDeferredDeleteObject(GPendingFrameTimelineValue, std::move(resource.m_SwapChain));
 
         PushDeferredDeleteCallback(GPendingFrameTimelineValue, [this, surface = resource.m_VkSurface.release()]() mutable
@@ -946,6 +1135,7 @@ namespace YT
 
     void RenderManager::CleanupImmediately()
     {
+        WaitForFrameSubmit();
         m_Device->waitIdle();
 
         while (!m_DeferredDeleteInfos.empty())
@@ -1775,26 +1965,84 @@ namespace YT
             vk::Rect2D render_area(vk::Offset2D(), resource.m_SwapChainExtent);
 
             vk::RenderingInfoKHR rendering_info;
+            rendering_info.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
             rendering_info.renderArea = render_area;
             rendering_info.layerCount = 1;
             rendering_info.setColorAttachments(color_attachments);
 
             command_buffer->beginRendering(rendering_info);
+            return true;
+        }
+        catch (vk::SystemError& err)
+        {
+            FatalPrint("Failed to prepare command buffer: {}", err.what());
+        }
+        catch (...)
+        {
+            FatalPrint("Failed to prepare command buffer: unknown exception");
+        }
+
+        return false;
+    }
+
+    bool RenderManager::RecordWindowContents(WindowResource & resource) noexcept
+    {
+        try
+        {
+            const vk::UniqueCommandBuffer & command_buffer = resource.m_ContentCommandBuffers[resource.m_FrameIndex];
+
+            command_buffer->reset();
+
+            std::array color_attachment_formats = { resource.m_SwapChainFormat };
+
+            vk::CommandBufferInheritanceRenderingInfo inheritance_rendering_info;
+            inheritance_rendering_info.setColorAttachmentFormats(color_attachment_formats);
+            inheritance_rendering_info.setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+            vk::CommandBufferInheritanceInfo inheritance_info;
+            inheritance_info.pNext = &inheritance_rendering_info;
+
+            vk::CommandBufferBeginInfo begin_info;
+            begin_info.flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+            begin_info.pInheritanceInfo = &inheritance_info;
+            command_buffer->begin(begin_info);
+
+            // Dynamic state isn't inherited from the primary command buffer
+            vk::Rect2D render_area(vk::Offset2D(), resource.m_SwapChainExtent);
 
             vk::Viewport viewport(0, 0,
                 resource.m_SwapChainExtent.width, resource.m_SwapChainExtent.height, 0.0f, 1.0f);
             command_buffer->setViewport(0, 1, &viewport);
 
             command_buffer->setScissor(0, 1, &render_area);
+
+            DrawerData drawer_data;
+            drawer_data.m_ViewportSize = glm::vec2(resource.m_SwapChainExtent.width, resource.m_SwapChainExtent.height);
+            drawer_data.m_Size = drawer_data.m_ViewportSize;
+            drawer_data.m_Offset = glm::vec2(0.0f);
+
+            PSODeferredSettings pso_deferred_settings;
+            pso_deferred_settings.m_SurfaceFormat = resource.m_SwapChainFormat;
+            pso_deferred_settings.m_BufferDescriptorSetId = m_BufferDescriptorSetId;
+
+            Drawer drawer(command_buffer.get(), drawer_data, pso_deferred_settings);
+            resource.m_Widget->OnDraw(drawer);
+
+            drawer.Flush();
+
+            command_buffer->end();
+
+            resource.m_ContentExtent = resource.m_SwapChainExtent;
+            resource.m_ContentFormat = resource.m_SwapChainFormat;
             return true;
         }
         catch (vk::SystemError& err)
         {
-            FatalPrint("Failed to prepare command buffer: {}", err.what());
+            FatalPrint("Failed to record window: {}", err.what());
         }
         catch (...)
         {
-            FatalPrint("Failed to prepare command buffer: unknown exception");
+            FatalPrint("Failed to record window: unknown exception");
         }
 
         return false;
@@ -159,6 +159,15 @@ namespace YT
         int m_QuadRenderTypeIndex = 0;
     };
 
+    /// Time from a frame starting to record until the CPU sees the GPU finish it, checked at the start of every frame
+    export struct FrameLatencyStats
+    {
+        std::uint64_t m_NumFrames = 0;          ///< Frames measured so far
+        std::uint64_t m_LastLatencyUs = 0;
+        std::uint64_t m_MaxLatencyUs = 0;
+        std::uint64_t m_TotalLatencyUs = 0;     ///< Divide by m_NumFrames for the average
+    };
+
     export std::uint32_t GGraphicsQueueIndex = 0;
     export std::uint32_t GTransferQueueIndex = 0;
     export std::uint64_t GPendingFrameTimelineValue = 0;
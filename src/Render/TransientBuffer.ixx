@@ -181,7 +181,8 @@ namespace YT
         vma::UniqueBuffer m_Buffer;
         vma::UniqueAllocation m_Allocation;
 
-        using BufferSizeType = std::conditional_t<Threading::NumJobThreads == 1, TransientBufferSize<std::size_t>, TransientBufferSize<std::atomic<std::size_t>>>;
+        // The job thread count is only known at runtime, so reservations always go through the atomic counter
+        using BufferSizeType = TransientBufferSize<std::atomic<std::size_t>>;
         BufferSizeType m_BufferSize;
 
         std::byte * m_Ptr = nullptr;
@@ -2,6 +2,7 @@ module;
 
 //import_std
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
@@ -25,15 +26,6 @@ export module YT:Types;
 
 namespace YT
 {
-    /// Number of worker threads (including main thread)
-    export class Threading
-    {
-    public:
-        static constexpr std::size_t NumJobThreads = 4;
-        static constexpr std::size_t NumBackgroundThreads = 4;
-        static constexpr std::size_t NumFileMapperThreads = 8;
-    };
-
     export template<typename T>
     using Vector = std::vector<T>;
 
@@ -146,15 +138,85 @@ namespace YT
 
     export using Exception = std::runtime_error;
 
+    /// How a worker pool's threads are pinned to CPUs, see ThreadTopology for how the CPUs are classified
+    export enum class ThreadAffinityPolicy
+    {
+        None,               ///< Leave scheduling to the OS
+        PackL3,             ///< One CPU per thread, filling the L3 domain with the most fast cores before spilling over
+        PerformanceCores,   ///< Let the threads float over the performance cores (every CPU on non-hybrid machines)
+        EfficiencyCores,    ///< Let the threads float over the efficiency cores (every CPU on non-hybrid machines)
+    };
+
     export struct ApplicationInitInfo final
     {
         StringView m_ApplicationName = "YTApplication";
         int m_ApplicationVersion = 1;
 
-        std::size_t m_ThreadPoolSize = std::thread::hardware_concurrency();
+        std::size_t m_ThreadPoolSize = std::thread::hardware_concurrency();    ///< Number of job threads (including main thread)
+        std::size_t m_BackgroundThreadPoolSize = 4;
+        std::size_t m_FileMapperThreadPoolSize = 8;
+        ThreadAffinityPolicy m_JobThreadAffinity = ThreadAffinityPolicy::None;          ///< The main thread floats over the pool's CPUs, GetThreadCpuAssignments reports the result
+        ThreadAffinityPolicy m_BackgroundThreadAffinity = ThreadAffinityPolicy::None;
+        ThreadAffinityPolicy m_FileMapperThreadAffinity = ThreadAffinityPolicy::None;
+        bool m_DeterministicScheduling = false;     ///< Run every thread context's work on the main thread in a seeded order
+        std::uint64_t m_DeterministicSeed = 0;      ///< Picks the interleaving when m_DeterministicScheduling is set
+        bool m_PipelinedFrames = false;             ///< Submit and present on a dedicated thread while the main thread records the next frame
+        std::uint32_t m_MaxFramesInFlight = 2;      ///< Frames the CPU may record ahead of the GPU, clamped to the frame resource count and the smallest swap chain
+        std::uint32_t m_MainThreadWorkBudgetUs = 4000;  ///< Main thread queue time per frame, leftovers run next frame. 0 runs one item per frame.
         int m_UpdateRate = 60;
     };
 
+    /// Thread pool sizes and affinities, configured once from the ApplicationInitInfo before any of the pools are created
+    export class Threading
+    {
+    public:
+        static void Configure(const ApplicationInitInfo & init_info) noexcept
+        {
+            // hardware_concurrency is allowed to return 0 when it can't tell
+            s_NumJobThreads = std::max<std::size_t>(init_info.m_ThreadPoolSize, 1);
+            s_NumBackgroundThreads = std::max<std::size_t>(init_info.m_BackgroundThreadPoolSize, 1);
+            s_NumFileMapperThreads = std::max<std::size_t>(init_info.m_FileMapperThreadPoolSize, 1);
+
+            s_JobThreadAffinity = init_info.m_JobThreadAffinity;
+            s_BackgroundThreadAffinity = init_info.m_BackgroundThreadAffinity;
+            s_FileMapperThreadAffinity = init_info.m_FileMapperThreadAffinity;
+
+            s_DeterministicScheduling = init_info.m_DeterministicScheduling;
+            s_DeterministicSeed = init_info.m_DeterministicSeed;
+
+            if (s_DeterministicScheduling)
+            {
+                // The pools only idle in this mode, keep them minimal
+                s_NumJobThreads = 1;
+                s_NumBackgroundThreads = 1;
+                s_NumFileMapperThreads = 1;
+            }
+        }
+
+        [[nodiscard]] static std::size_t GetNumJobThreads() noexcept { return s_NumJobThreads; }
+        [[nodiscard]] static std::size_t GetNumBackgroundThreads() noexcept { return s_NumBackgroundThreads; }
+        [[nodiscard]] static std::size_t GetNumFileMapperThreads() noexcept { return s_NumFileMapperThreads; }
+
+        [[nodiscard]] static ThreadAffinityPolicy GetJobThreadAffinity() noexcept { return s_JobThreadAffinity; }
+        [[nodiscard]] static ThreadAffinityPolicy GetBackgroundThreadAffinity() noexcept { return s_BackgroundThreadAffinity; }
+        [[nodiscard]] static ThreadAffinityPolicy GetFileMapperThreadAffinity() noexcept { return s_FileMapperThreadAffinity; }
+
+        [[nodiscard]] static bool IsDeterministicScheduling() noexcept { return s_DeterministicScheduling; }
+        [[nodiscard]] static std::uint64_t GetDeterministicSeed() noexcept { return s_DeterministicSeed; }
+
+    private:
+        static inline std::size_t s_NumJobThreads = 4;
+        static inline std::size_t s_NumBackgroundThreads = 4;
+        static inline std::size_t s_NumFileMapperThreads = 8;
+
+        static inline ThreadAffinityPolicy s_JobThreadAffinity = ThreadAffinityPolicy::None;
+        static inline ThreadAffinityPolicy s_BackgroundThreadAffinity = ThreadAffinityPolicy::None;
+        static inline ThreadAffinityPolicy s_FileMapperThreadAffinity = ThreadAffinityPolicy::None;
+
+        static inline bool s_DeterministicScheduling = false;
+        static inline std::uint64_t s_DeterministicSeed = 0;
+    };
+
     export struct WindowInitInfo final
     {
         String m_WindowName = "YTWindow";
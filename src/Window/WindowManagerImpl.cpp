@@ -31,6 +31,7 @@ import :WindowTable;
 import :WindowResource;
 import :RenderManager;
 import :WindowManager;
+import :FrameTiming;
 
 namespace YT
 {
@@ -170,6 +171,10 @@ namespace YT
         while (HasOpenWindows())
         {
             int ret = poll(&pfd, 1, 1);
+
+            // The 1ms poll timeout doubles as the timer tick
+            AdvanceFrameTimers();
+
             switch (ret)
             {
             case -1:
@@ -180,6 +185,7 @@ namespace YT
 
                 if (m_HasDirtyWindows)
                 {
+                    SignalNextFrame();
                     return;
                 }
                 break;
@@ -190,6 +196,7 @@ namespace YT
 
                 if (m_HasDirtyWindows)
                 {
+                    SignalNextFrame();
                     return;
                 }
                 break;
@@ -39,6 +39,10 @@ namespace YT
         Vector<vk::UniqueSemaphore> m_RenderFinishedSemaphores;
         Vector<std::uint64_t> m_FrameSemaphoreValues;
         Vector<vk::UniqueCommandBuffer> m_CommandBuffers;
+        Vector<vk::UniqueCommandBuffer> m_ContentCommandBuffers;    ///< Secondary buffers holding the widget draws
+
+        vk::Extent2D m_ContentExtent = {};                          ///< Swap chain extent the content buffers were recorded for
+        vk::Format m_ContentFormat = vk::Format::eUndefined;
 
         vk::Extent2D m_RequestedExtent = {};
         vk::Extent2D m_SwapChainExtent = {};
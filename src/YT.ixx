@@ -17,8 +17,21 @@ export import :MultiProducerSingleConsumer;
 export import :MultiProducerMultiConsumer;
 export import :Init;
 export import :Delegate;
+export import :InplaceFunction;
 export import :Coroutine;
+export import :Cancellation;
 export import :CoroEvent;
+export import :CoroMutex;
+export import :CoroSemaphore;
+export import :CoroChannel;
+export import :TimerWheel;
+export import :FrameTiming;
+export import :CoroCombinators;
+export import :Parallel;
+export import :TaskGraph;
+export import :JobTrace;
+export import :DeterministicScheduler;
+export import :ThreadTopology;
 export import :Wait;
 export import :Window;
 export import :Widget;
@@ -0,0 +1,132 @@
+module;
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+export module YT:DeterministicSchedulerTests;
+
+import :DeterministicScheduler;
+import :JobTypes;
+import :Coroutine;
+
+namespace YT
+{
+    class DeterministicSchedulerTest : public ::testing::Test
+    {
+    };
+
+    /// Pushes a fan of tasks across contexts, some of which push more, and returns the order they ran in
+    std::vector<int> RunWorkload(DeterministicScheduler & scheduler)
+    {
+        static constexpr ThreadContextType Contexts[] =
+        {
+            ThreadContextType::Job, ThreadContextType::Background, ThreadContextType::FileMapper,
+            ThreadContextType::FreeType, ThreadContextType::Main,
+        };
+
+        // Tasks capture one pointer and an index so they fit in a WorkFunction
+        struct Workload
+        {
+            DeterministicScheduler & m_Scheduler;
+            std::vector<int> m_Order;
+        };
+
+        Workload workload{ scheduler, {} };
+        for (int i = 0; i < 32; ++i)
+        {
+            scheduler.Push(Contexts[i % 5], [&workload, i]
+            {
+                workload.m_Order.push_back(i);
+                if (i % 4 == 0)
+                {
+                    workload.m_Scheduler.Push(ThreadContextType::Job, [&workload, i] { workload.m_Order.push_back(100 + i); });
+                }
+            });
+        }
+
+        scheduler.RunUntilIdle();
+        return workload.m_Order;
+    }
+
+    TEST_F(DeterministicSchedulerTest, SameSeedSameTrace)
+    {
+        DeterministicScheduler first(1234);
+        DeterministicScheduler second(1234);
+
+        const std::vector<int> first_order = RunWorkload(first);
+        const std::vector<int> second_order = RunWorkload(second);
+
+        EXPECT_EQ(first_order.size(), 40u);
+        EXPECT_EQ(first_order, second_order);
+        EXPECT_EQ(first.GetTraceHash(), second.GetTraceHash());
+    }
+
+    TEST_F(DeterministicSchedulerTest, DifferentSeedsInterleaveDifferently)
+    {
+        DeterministicScheduler reference(1);
+        const std::vector<int> reference_order = RunWorkload(reference);
+
+        bool any_different = false;
+        for (std::uint64_t seed = 2; seed < 10 && !any_different; ++seed)
+        {
+            DeterministicScheduler other(seed);
+            any_different = RunWorkload(other) != reference_order;
+        }
+
+        EXPECT_TRUE(any_different);
+    }
+
+    TEST_F(DeterministicSchedulerTest, RunsWithTaskContextAndRestoresIt)
+    {
+        DeterministicScheduler scheduler(7);
+
+        const ThreadContextType previous = GetCurrentThreadContext();
+        ThreadContextType seen = ThreadContextType::Unknown;
+
+        scheduler.Push(ThreadContextType::FileMapper, [&seen] { seen = GetCurrentThreadContext(); });
+        EXPECT_TRUE(scheduler.RunNext());
+        EXPECT_FALSE(scheduler.RunNext());
+
+        EXPECT_EQ(seen, ThreadContextType::FileMapper);
+        EXPECT_EQ(GetCurrentThreadContext(), previous);
+    }
+
+    TEST_F(DeterministicSchedulerTest, VirtualTimeAndTrace)
+    {
+        DeterministicScheduler scheduler(42);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            scheduler.Push(i % 2 ? ThreadContextType::Background : ThreadContextType::Job, [] {});
+        }
+
+        EXPECT_EQ(scheduler.GetNumReadyTasks(), 5u);
+        EXPECT_EQ(scheduler.RunUntilIdle(), 5u);
+        EXPECT_EQ(scheduler.GetVirtualTime(), 5u);
+
+        const Span<const DeterministicTraceEntry> trace = scheduler.GetTrace();
+        ASSERT_EQ(trace.size(), 5u);
+
+        std::vector<bool> seen_ids(5, false);
+        for (std::size_t i = 0; i < trace.size(); ++i)
+        {
+            EXPECT_EQ(trace[i].m_VirtualTime, i);
+            ASSERT_LT(trace[i].m_TaskId, 5u);
+            EXPECT_FALSE(seen_ids[trace[i].m_TaskId]);
+            seen_ids[trace[i].m_TaskId] = true;
+            EXPECT_EQ(trace[i].m_Context, trace[i].m_TaskId % 2 ? ThreadContextType::Background : ThreadContextType::Job);
+        }
+
+        scheduler.ClearTrace();
+        EXPECT_TRUE(scheduler.GetTrace().empty());
+        EXPECT_EQ(scheduler.GetContextCostNs(ThreadContextType::Job), 0u);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
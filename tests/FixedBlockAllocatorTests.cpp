@@ -5,6 +5,8 @@ module;
 #include <vector>
 #include <atomic>
 #include <random>
+#include <cstddef>
+#include <cstdint>
 
 export module YT:FixedBlockAllocatorTests;
 
@@ -256,6 +258,55 @@ namespace YT::Tests
         ASSERT_NE(ptr, nullptr);
         allocator.Free(ptr);
     }
+
+    TEST(ThreadCachedFixedBlockAllocatorHitTest, ReportsLocalCacheHits)
+    {
+        ThreadCachedFixedBlockAllocator<uint64_t, 8, 16> small_allocator;
+
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 16; ++i)
+        {
+            bool local_hit = false;
+            ptrs.push_back(small_allocator.Allocate(local_hit));
+            ASSERT_NE(ptrs.back(), nullptr);
+            EXPECT_TRUE(local_hit);
+        }
+
+        // The local cache is capped at 16 blocks so this one comes from the shared pool
+        bool local_hit = true;
+        ptrs.push_back(small_allocator.Allocate(local_hit));
+        ASSERT_NE(ptrs.back(), nullptr);
+        EXPECT_FALSE(local_hit);
+
+        for (void* ptr : ptrs)
+        {
+            small_allocator.Free(ptr);
+        }
+    }
+
+    TEST(ThreadCachedFixedBlockAllocatorHitTest, HonorsBlockAlignment)
+    {
+        struct alignas(64) AlignedBlock
+        {
+            std::byte m_Data[128];
+        };
+
+        ThreadCachedFixedBlockAllocator<AlignedBlock, 8, 16> aligned_allocator;
+
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 32; ++i)
+        {
+            void* ptr = aligned_allocator.Allocate();
+            ASSERT_NE(ptr, nullptr);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignof(AlignedBlock), 0u);
+            ptrs.push_back(ptr);
+        }
+
+        for (void* ptr : ptrs)
+        {
+            aligned_allocator.Free(ptr);
+        }
+    }
 }
 
 int main(int argc, char **argv)
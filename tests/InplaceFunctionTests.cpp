@@ -0,0 +1,147 @@
+module;
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+export module YT:InplaceFunctionTests;
+
+import :InplaceFunction;
+
+namespace YT
+{
+    class InplaceFunctionTest : public ::testing::Test
+    {
+    };
+
+    /// Counts live instances so tests can check the stored callable is destroyed exactly once
+    struct LifetimeCounter
+    {
+        explicit LifetimeCounter(int & live) noexcept
+            : m_Live(&live)
+        {
+            ++*m_Live;
+        }
+
+        LifetimeCounter(LifetimeCounter && rhs) noexcept
+            : m_Live(rhs.m_Live)
+        {
+            ++*m_Live;
+        }
+
+        ~LifetimeCounter()
+        {
+            --*m_Live;
+        }
+
+        int operator()() const noexcept
+        {
+            return 7;
+        }
+
+        int * m_Live = nullptr;
+    };
+
+    TEST_F(InplaceFunctionTest, EmptyByDefault)
+    {
+        InplaceFunction<void(), 16> function;
+        EXPECT_FALSE(function);
+
+        InplaceFunction<void(), 16> null_function = nullptr;
+        EXPECT_FALSE(null_function);
+    }
+
+    TEST_F(InplaceFunctionTest, CallsCapturedLambda)
+    {
+        int counter = 0;
+        InplaceFunction<void(), 16> function = [&counter] { ++counter; };
+
+        EXPECT_TRUE(function);
+        function();
+        function();
+        EXPECT_EQ(counter, 2);
+    }
+
+    TEST_F(InplaceFunctionTest, ForwardsArgumentsAndReturnsValue)
+    {
+        InplaceFunction<int(int, int), 16> add = [](int a, int b) { return a + b; };
+        EXPECT_EQ(add(2, 3), 5);
+
+        InplaceFunction<std::size_t(std::string &&), 16> length = [](std::string && str) { return str.size(); };
+        EXPECT_EQ(length(std::string("hello")), 5u);
+    }
+
+    TEST_F(InplaceFunctionTest, VoidSignatureDiscardsResult)
+    {
+        int live = 0;
+        InplaceFunction<void(), 16> function = LifetimeCounter(live);
+        function();
+        EXPECT_EQ(live, 1);
+    }
+
+    TEST_F(InplaceFunctionTest, HoldsMoveOnlyCallable)
+    {
+        auto value = std::make_unique<int>(42);
+        InplaceFunction<int(), 16> function = [value = std::move(value)] { return *value; };
+
+        InplaceFunction<int(), 16> moved = std::move(function);
+        EXPECT_FALSE(function);
+        ASSERT_TRUE(moved);
+        EXPECT_EQ(moved(), 42);
+    }
+
+    TEST_F(InplaceFunctionTest, DestroysCallableExactlyOnce)
+    {
+        int live = 0;
+        {
+            InplaceFunction<int(), 16> function = LifetimeCounter(live);
+            EXPECT_EQ(live, 1);
+
+            InplaceFunction<int(), 16> moved = std::move(function);
+            EXPECT_EQ(live, 1);
+            EXPECT_EQ(moved(), 7);
+
+            InplaceFunction<int(), 16> assigned;
+            assigned = std::move(moved);
+            EXPECT_EQ(live, 1);
+
+            assigned = nullptr;
+            EXPECT_EQ(live, 0);
+            EXPECT_FALSE(assigned);
+
+            assigned = LifetimeCounter(live);
+            EXPECT_EQ(live, 1);
+        }
+        EXPECT_EQ(live, 0);
+    }
+
+    TEST_F(InplaceFunctionTest, MoveAssignReplacesExistingCallable)
+    {
+        int first_live = 0;
+        int second_live = 0;
+
+        InplaceFunction<int(), 16> first = LifetimeCounter(first_live);
+        InplaceFunction<int(), 16> second = LifetimeCounter(second_live);
+
+        first = std::move(second);
+        EXPECT_EQ(first_live, 0);
+        EXPECT_EQ(second_live, 1);
+        EXPECT_FALSE(second);
+    }
+
+    TEST_F(InplaceFunctionTest, SlotIsNoWiderThanBufferPlusDispatch)
+    {
+        static_assert(sizeof(InplaceFunction<void(), 16>) == 16 + sizeof(void *));
+        static_assert(sizeof(InplaceFunction<void(), 8>) == 8 + sizeof(void *));
+        static_assert(std::is_nothrow_move_constructible_v<InplaceFunction<void(), 16>>);
+        static_assert(!std::is_copy_constructible_v<InplaceFunction<void(), 16>>);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -5,11 +5,32 @@ module;
 #include <atomic>
 #include <chrono>
 #include <coroutine>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
 
 module YT:JobManagerTests;
 
 import :JobManager;
+import :JobTypes;
+import :Coroutine;
 import :Types;
+import :Wait;
+import :TaskGraph;
+import :CoroCombinators;
+import :BackgroundTaskManager;
+import :CoroChannel;
+import :CoroEvent;
+import :CoroWaitQueue;
+import :CoroMutex;
+import :CoroSemaphore;
+import :Cancellation;
+import :ImageLoad;
+import :ImageReference;
+import :Parallel;
 
 using namespace YT;
 
@@ -19,7 +40,11 @@ class JobManagerTest : public ::testing::Test
 protected:
     void SetUp() override
     {
+        InitWait();
+        SetCurrentThreadContext(ThreadContextType::Main);
+
         JobManager::CreateJobManager();
+        BackgroundTaskManager::CreateBackgroundTaskManager();
         g_JobManager->PrepareToRunJobs();
     }
 
@@ -44,9 +69,9 @@ JobCoro<int> ReturnValue(int value)
 }
 
 // Test coroutine that runs on main thread
-JobCoroMainThread<void> MainThreadJob(std::atomic<bool>& executed)
+MainThreadTask<void> MainThreadJob(std::atomic<bool>& executed)
 {
-    EXPECT_EQ(g_JobManager->GetThreadId(), 0);  // Should run on main thread
+    EXPECT_EQ(GetCurrentThreadContext(), ThreadContextType::Main);  // Should run on main thread
     executed.store(true, std::memory_order_release);
     co_return;
 }
@@ -55,7 +80,7 @@ JobCoroMainThread<void> MainThreadJob(std::atomic<bool>& executed)
 TEST_F(JobManagerTest, BasicJobExecution)
 {
     std::atomic<int> counter{0};
-    JobList<void> jobs;
+    CoroBundle<void> jobs;
     
     // Create and run a simple job
     jobs.PushJob(IncrementCounter(counter));
@@ -66,7 +91,7 @@ TEST_F(JobManagerTest, BasicJobExecution)
 
 TEST_F(JobManagerTest, ReturnValue)
 {
-    JobList<int> jobs;
+    CoroBundle<int> jobs;
     
     // Create and run a job that returns a value
     jobs.PushJob(ReturnValue(42));
@@ -78,7 +103,7 @@ TEST_F(JobManagerTest, ReturnValue)
 TEST_F(JobManagerTest, MultipleJobs)
 {
     std::atomic<int> counter{0};
-    JobList<void> jobs;
+    CoroBundle<void> jobs;
     
     // Create and run multiple jobs
     for (int i = 0; i < 10; ++i)
@@ -94,7 +119,7 @@ TEST_F(JobManagerTest, MultipleJobs)
 TEST_F(JobManagerTest, ConcurrentJobExecution)
 {
     std::atomic<int> counter{0};
-    JobList<void> jobs;
+    CoroBundle<void> jobs;
     
     // Create multiple jobs that will run concurrently
     for (int i = 0; i < 1000; ++i)
@@ -109,7 +134,7 @@ TEST_F(JobManagerTest, ConcurrentJobExecution)
 TEST_F(JobManagerTest, MainThreadJobs)
 {
     std::atomic<bool> executed{false};
-    JobList<void> jobs;
+    CoroBundle<void> jobs;
     
     // Create and run a main thread job
     jobs.PushJob(MainThreadJob(executed));
@@ -121,16 +146,869 @@ TEST_F(JobManagerTest, MainThreadJobs)
 // Edge case tests
 TEST_F(JobManagerTest, EmptyJobList)
 {
-    JobList<void> jobs;
+    CoroBundle<void> jobs;
     jobs.WaitForCompletion();  // Should not hang
 }
 
+// Counts a run, flagging it if the node it depends on hasn't run the expected number of times yet
+JobCoro<void> CountAfter(const std::atomic<int>& dependency, int expected, std::atomic<int>& counter, std::atomic<bool>& in_order)
+{
+    if (dependency.load(std::memory_order_acquire) != expected)
+    {
+        in_order.store(false, std::memory_order_relaxed);
+    }
+
+    counter.fetch_add(1, std::memory_order_acq_rel);
+    co_return;
+}
+
+TEST_F(JobManagerTest, TaskGraphResubmitsDiamond)
+{
+    std::atomic<int> root_runs{0};
+    std::atomic<int> middle_runs{0};
+    std::atomic<int> leaf_runs{0};
+    std::atomic<bool> in_order{true};
+    int submit = 0;
+
+    // root -> { left, right (a coro node) } -> leaf
+    TaskGraph graph;
+    const TaskGraph::NodeId root = graph.AddNode([&] { root_runs.fetch_add(1, std::memory_order_acq_rel); });
+    const TaskGraph::NodeId left = graph.AddNode([&]
+    {
+        if (root_runs.load(std::memory_order_acquire) != submit)
+        {
+            in_order.store(false, std::memory_order_relaxed);
+        }
+        middle_runs.fetch_add(1, std::memory_order_acq_rel);
+    });
+    const TaskGraph::NodeId right = graph.AddCoroNode([&] { return CountAfter(root_runs, submit, middle_runs, in_order); });
+    const TaskGraph::NodeId leaf = graph.AddCoroNode([&] { return CountAfter(middle_runs, submit * 2, leaf_runs, in_order); });
+
+    graph.AddDependency(root, left);
+    graph.AddDependency(root, right);
+    graph.AddDependency(left, leaf);
+    graph.AddDependency(right, leaf);
+
+    // Every submit has to reset the dependency counters, or the leaf would run early or not at all the second time
+    for (submit = 1; submit <= 3; ++submit)
+    {
+        graph.Submit();
+        graph.WaitForCompletion();
+
+        EXPECT_TRUE(graph.IsComplete());
+        EXPECT_EQ(root_runs.load(), submit);
+        EXPECT_EQ(middle_runs.load(), submit * 2);
+        EXPECT_EQ(leaf_runs.load(), submit);
+    }
+
+    EXPECT_TRUE(in_order.load());
+}
+
+// Children for the combinator tests, each checks it ran on the context it asked for
+JobCoro<int> JobValue(int value)
+{
+    EXPECT_EQ(GetCurrentThreadContext(), ThreadContextType::Job);
+    co_return value;
+}
+
+BackgroundTask<int> BackgroundValue(int value)
+{
+    EXPECT_EQ(GetCurrentThreadContext(), ThreadContextType::Background);
+    co_return value;
+}
+
+MainThreadTask<int> MainThreadValue(int value)
+{
+    EXPECT_EQ(GetCurrentThreadContext(), ThreadContextType::Main);
+    co_return value;
+}
+
+JobCoro<int> HopToMain(int value)
+{
+    co_return co_await MainThreadValue(value);
+}
+
+// Runs from the main thread queue and blocks there on a job that itself needs the main thread queue
+MainThreadTask<int> BlockOnMainHop(int value)
+{
+    CoroBundle<int> inner;
+    inner.PushJob(HopToMain(value));
+    inner.WaitForCompletion();
+    co_return inner[0];
+}
+
+JobCoro<int> BlockInMainContinuation(int value)
+{
+    co_return co_await BlockOnMainHop(value);
+}
+
+TEST_F(JobManagerTest, MainThreadContinuationCanBlock)
+{
+    CoroBundle<int> jobs;
+    for (int i = 0; i < 8; ++i)
+    {
+        jobs.PushJob(BlockInMainContinuation(i));
+    }
+    jobs.WaitForCompletion();
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(jobs[i], static_cast<int>(i));
+    }
+}
+
+JobCoro<int> WhenAllMixedContexts(std::atomic<int>& counter)
+{
+    auto [job, background, main, nothing] = co_await WhenAll(
+        JobValue(1), BackgroundValue(2), MainThreadValue(3), IncrementCounter(counter));
+
+    // Whichever child finished last, we come back on our own context
+    EXPECT_EQ(GetCurrentThreadContext(), ThreadContextType::Job);
+    co_return job * 100 + background * 10 + main;
+}
+
+TEST_F(JobManagerTest, WhenAllMixedContextsKeepsResultOrder)
+{
+    std::atomic<int> counter{0};
+    CoroBundle<int> jobs;
+
+    for (int i = 0; i < 50; ++i)
+    {
+        jobs.PushJob(WhenAllMixedContexts(counter));
+    }
+    jobs.WaitForCompletion();
+
+    for (std::size_t i = 0; i < 50; ++i)
+    {
+        EXPECT_EQ(jobs[i], 123);
+    }
+    EXPECT_EQ(counter.load(), 50);
+}
+
+// Doesn't finish until released, so it is guaranteed to lose a WhenAny
+template <typename CoroT>
+CoroT SlowValue(const std::atomic<bool>& release, std::atomic<int>& finished, int value)
+{
+    while (!release.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    finished.fetch_add(1, std::memory_order_acq_rel);
+    co_return value;
+}
+
+JobCoro<int> WhenAnyWithSlowLosers(const std::atomic<bool>& release, std::atomic<int>& finished)
+{
+    auto result = co_await WhenAny(
+        SlowValue<BackgroundTask<int>>(release, finished, 1), JobValue(7), SlowValue<JobCoro<int>>(release, finished, 2));
+
+    EXPECT_EQ(result.m_Index, 1u);
+    co_return std::get<1>(result.m_Result);
+}
+
+TEST_F(JobManagerTest, WhenAnyStateOutlivesSlowLosers)
+{
+    std::atomic<bool> release{false};
+    std::atomic<int> finished{0};
+
+    {
+        CoroBundle<int> jobs;
+        jobs.PushJob(WhenAnyWithSlowLosers(release, finished));
+        jobs.WaitForCompletion();
+
+        EXPECT_EQ(jobs[0], 7);
+        EXPECT_EQ(finished.load(), 0);
+    }
+
+    // The awaiting coroutine is gone, the losers now finish on their own threads and free the shared state
+    release.store(true, std::memory_order_release);
+    while (finished.load(std::memory_order_acquire) < 2)
+    {
+        std::this_thread::yield();
+    }
+
+    g_BackgroundTaskManager->SyncAll();
+}
+
+MainThreadTask<int> ReceiveOne(CoroChannel<int, 1> & channel)
+{
+    const Optional<int> value = co_await channel.Receive();
+    co_return value.value_or(-1);
+}
+
+TEST_F(JobManagerTest, ChannelHandsValueToWaitingReceiver)
+{
+    CoroChannel<int, 1> channel;
+    CoroBundle<int> jobs;
+
+    // Started from the main thread, so the receiver runs inline and is already waiting on the empty channel
+    jobs.PushJob(ReceiveOne(channel));
+    EXPECT_FALSE(jobs.IsComplete());
+
+    int value = 5;
+    EXPECT_TRUE(channel.TrySend(value));
+    EXPECT_EQ(channel.Size(), 0u);
+
+    jobs.WaitForCompletion();
+    EXPECT_EQ(jobs[0], 5);
+}
+
+JobCoro<void> SendSequence(CoroChannel<int, 2> & channel, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const bool sent = co_await channel.Send(i);
+        EXPECT_TRUE(sent);
+    }
+
+    channel.Close();
+}
+
+JobCoro<int> ReceiveSequence(CoroChannel<int, 2> & channel)
+{
+    int expected = 0;
+    while (const Optional<int> value = co_await channel.Receive())
+    {
+        EXPECT_EQ(*value, expected);
+        ++expected;
+    }
+
+    co_return expected;
+}
+
+TEST_F(JobManagerTest, ChannelKeepsOrderThroughFullAndEmpty)
+{
+    // Two slots and two threads, so the channel keeps filling up and draining while the values go through
+    const int count = 1000;
+    CoroChannel<int, 2> channel;
+    CoroBundle<int> receiver;
+    CoroBundle<void> sender;
+
+    receiver.PushJob(ReceiveSequence(channel));
+    sender.PushJob(SendSequence(channel, count));
+    sender.WaitForCompletion();
+    receiver.WaitForCompletion();
+
+    EXPECT_EQ(receiver[0], count);
+    EXPECT_TRUE(channel.IsClosed());
+}
+
+MainThreadTask<bool> SendUntilBlocked(CoroChannel<int, 1> & channel)
+{
+    const bool first = co_await channel.Send(1);
+    EXPECT_TRUE(first);
+
+    co_return co_await channel.Send(2);
+}
+
+TEST_F(JobManagerTest, ChannelCloseWakesBlockedSender)
+{
+    CoroChannel<int, 1> channel;
+    CoroBundle<bool> jobs;
+
+    // The first value fills the channel and the second send suspends
+    jobs.PushJob(SendUntilBlocked(channel));
+    EXPECT_FALSE(jobs.IsComplete());
+    EXPECT_EQ(channel.Size(), 1u);
+
+    channel.Close();
+    jobs.WaitForCompletion();
+    EXPECT_FALSE(jobs[0]);
+
+    // What was buffered before the close can still be received, the dropped value can't
+    EXPECT_EQ(channel.TryReceive().value_or(-1), 1);
+    EXPECT_FALSE(channel.TryReceive().has_value());
+}
+
+JobCoro<void> IncrementUnderLock(CoroMutex & mutex, int & counter, std::atomic<int> & holders, std::atomic<bool> & overlapped)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        const CoroLockGuard guard = co_await mutex.ScopedLock();
+        if (holders.fetch_add(1, std::memory_order_acq_rel) != 0)
+        {
+            overlapped.store(true, std::memory_order_relaxed);
+        }
+
+        ++counter;
+        holders.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+TEST_F(JobManagerTest, CoroMutexExcludesJobs)
+{
+    CoroMutex mutex;
+    int counter = 0;
+    std::atomic<int> holders{0};
+    std::atomic<bool> overlapped{false};
+    CoroBundle<void> jobs;
+
+    for (int i = 0; i < 50; ++i)
+    {
+        jobs.PushJob(IncrementUnderLock(mutex, counter, holders, overlapped));
+    }
+    jobs.WaitForCompletion();
+
+    EXPECT_EQ(counter, 5000);
+    EXPECT_FALSE(overlapped.load());
+    EXPECT_TRUE(mutex.TryLock());
+    EXPECT_FALSE(mutex.TryLock());
+    mutex.Unlock();
+}
+
+MainThreadTask<void> AcquireAndCount(CoroSemaphore & semaphore, std::atomic<int> & acquired)
+{
+    co_await semaphore.Acquire();
+    acquired.fetch_add(1, std::memory_order_acq_rel);
+}
+
+TEST_F(JobManagerTest, CoroSemaphoreReleaseHandsPermitsToWaiters)
+{
+    CoroSemaphore semaphore;
+    std::atomic<int> acquired{0};
+    CoroBundle<void> jobs;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        jobs.PushJob(AcquireAndCount(semaphore, acquired));
+    }
+    EXPECT_EQ(acquired.load(), 0);
+
+    // Permits go to the oldest waiters first and only the leftover is banked
+    semaphore.Release(2);
+    EXPECT_EQ(acquired.load(), 2);
+    EXPECT_EQ(semaphore.GetAvailable(), 0u);
+
+    semaphore.Release(2);
+    jobs.WaitForCompletion();
+    EXPECT_EQ(acquired.load(), 3);
+    EXPECT_EQ(semaphore.GetAvailable(), 1u);
+}
+
+JobCoro<void> HoldPermit(CoroSemaphore & semaphore, std::atomic<int> & holders, std::atomic<int> & max_holders)
+{
+    co_await semaphore.Acquire();
+
+    const int now = holders.fetch_add(1, std::memory_order_acq_rel) + 1;
+    int seen = max_holders.load(std::memory_order_relaxed);
+    while (now > seen && !max_holders.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+
+    std::this_thread::yield();
+    holders.fetch_sub(1, std::memory_order_acq_rel);
+    semaphore.Release();
+}
+
+TEST_F(JobManagerTest, CoroSemaphoreLimitsConcurrency)
+{
+    CoroSemaphore semaphore(2);
+    std::atomic<int> holders{0};
+    std::atomic<int> max_holders{0};
+    CoroBundle<void> jobs;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        jobs.PushJob(HoldPermit(semaphore, holders, max_holders));
+    }
+    jobs.WaitForCompletion();
+
+    EXPECT_GE(max_holders.load(), 1);
+    EXPECT_LE(max_holders.load(), 2);
+    EXPECT_EQ(semaphore.GetAvailable(), 2u);
+}
+
+JobCoro<int> AwaitChildren(std::atomic<int> & counter, std::atomic<bool> & reached_end)
+{
+    co_await IncrementCounter(counter);
+    const int value = co_await ReturnValue(42);
+
+    reached_end.store(true, std::memory_order_release);
+    co_return value;
+}
+
+TEST_F(JobManagerTest, CancelledParentSkipsChildren)
+{
+    std::atomic<int> counter{0};
+    std::atomic<bool> reached_end{false};
+    CancellationSource source;
+    CoroBundle<int> jobs;
+
+    jobs.PushJob(AwaitChildren(counter, reached_end).WithCancellation(source.GetToken()));
+    jobs.WaitForCompletion();
+    EXPECT_EQ(jobs[0], 42);
+    EXPECT_EQ(counter.load(), 1);
+
+    // The parent itself still runs, every child it awaits is skipped and hands back a default result
+    source.Cancel();
+    reached_end.store(false, std::memory_order_relaxed);
+
+    CoroBundle<int> cancelled;
+    cancelled.PushJob(AwaitChildren(counter, reached_end).WithCancellation(source.GetToken()));
+    cancelled.WaitForCompletion();
+    EXPECT_EQ(cancelled[0], 0);
+    EXPECT_EQ(counter.load(), 1);
+    EXPECT_TRUE(reached_end.load());
+}
+
+TEST_F(JobManagerTest, CancelledImageLoadReturnsEarly)
+{
+    // There is no file mapper or render manager in this test, so finishing at all means neither was touched
+    const StringView file_name = "missing.png";
+    CancellationSource source;
+    source.Cancel();
+
+    CoroBundle<ImageReference> loads;
+    loads.PushJob(LoadImageFromFile(file_name).WithCancellation(source.GetToken()));
+    loads.WaitForCompletion();
+
+    EXPECT_FALSE(loads[0]);
+}
+
+TEST_F(JobManagerTest, ParallelForAutoGrain)
+{
+    // Around 16 chunks per thread once the guided chunks have shrunk, never below one index
+    EXPECT_EQ(ResolveGrain(1000, 0, 4), 15u);
+    EXPECT_EQ(ResolveGrain(10, 0, 4), 1u);
+    EXPECT_EQ(ResolveGrain(1000, 7, 4), 7u);
+
+    const std::size_t count = 100000;
+    const std::size_t grain = ResolveGrain(count, 0, GetParallelism());
+    Mutex mutex;
+    Vector<std::pair<std::size_t, std::size_t>> chunks;
+
+    ParallelFor(count, 0, [&](std::size_t chunk_begin, std::size_t chunk_end)
+    {
+        const std::scoped_lock lock(mutex);
+        chunks.emplace_back(chunk_begin, chunk_end);
+    });
+
+    // The chunks tile the range, and only the one at the very end may come in under the grain
+    std::sort(chunks.begin(), chunks.end());
+    std::size_t next = 0;
+    for (const auto & [chunk_begin, chunk_end] : chunks)
+    {
+        EXPECT_EQ(chunk_begin, next);
+        EXPECT_GT(chunk_end, chunk_begin);
+        if (chunk_end != count)
+        {
+            EXPECT_GE(chunk_end - chunk_begin, grain);
+        }
+        next = chunk_end;
+    }
+    EXPECT_EQ(next, count);
+}
+
+TEST_F(JobManagerTest, ParallelForVisitsEveryIndexOnce)
+{
+    const std::size_t count = 100000;
+    Vector<std::atomic<int>> visits(count);
+    std::atomic<int> out_of_range{0};
+
+    ParallelFor(10, 10 + count, 0, [&](std::size_t index)
+    {
+        if (index < 10 || index >= 10 + count)
+        {
+            out_of_range.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        visits[index - 10].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    EXPECT_EQ(out_of_range.load(), 0);
+    EXPECT_TRUE(std::ranges::all_of(visits, [](const std::atomic<int> & visit) { return visit.load() == 1; }));
+}
+
+TEST_F(JobManagerTest, ParallelForRunsInline)
+{
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<int> elsewhere{0};
+    std::atomic<int> visited{0};
+
+    auto body = [&](std::size_t)
+    {
+        if (std::this_thread::get_id() != caller)
+        {
+            elsewhere.fetch_add(1, std::memory_order_relaxed);
+        }
+        visited.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    // A range that fits in one grain never leaves the calling thread
+    ParallelFor(10, 100, body);
+    EXPECT_EQ(visited.load(), 10);
+
+    // Neither does anything once the job threads have stopped
+    g_JobManager->StopRunningJobs();
+    EXPECT_EQ(GetParallelism(), 1u);
+
+    ParallelFor(10000, 1, body);
+    EXPECT_EQ(visited.load(), 10010);
+    EXPECT_EQ(ParallelReduce(1000, 1, 0, [](std::size_t index) { return static_cast<int>(index); }, std::plus<>{}), 499500);
+    EXPECT_EQ(elsewhere.load(), 0);
+}
+
+TEST_F(JobManagerTest, ParallelReduceMatchesSerialSum)
+{
+    const std::size_t count = 100000;
+
+    std::uint64_t serial = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        serial += static_cast<std::uint64_t>(index) * index;
+    }
+
+    auto square = [](std::size_t index) { return static_cast<std::uint64_t>(index) * index; };
+    auto sum_chunk = [](std::size_t chunk_begin, std::size_t chunk_end, std::uint64_t accumulated)
+    {
+        for (std::size_t index = chunk_begin; index < chunk_end; ++index)
+        {
+            accumulated += static_cast<std::uint64_t>(index) * index;
+        }
+        return accumulated;
+    };
+
+    EXPECT_EQ(ParallelReduce(count, 0, std::uint64_t{0}, square, std::plus<>{}), serial);
+    EXPECT_EQ(ParallelReduce(count, 1, std::uint64_t{0}, square, std::plus<>{}), serial);
+    EXPECT_EQ(ParallelReduce(count, 0, std::uint64_t{0}, sum_chunk, std::plus<>{}), serial);
+    EXPECT_EQ(ParallelReduce(0, 0, std::uint64_t{7}, square, std::plus<>{}), 7u);
+}
+
+MainThreadTask<void> WaitAndRecord(CoroEvent & event, Vector<int> & order, int id)
+{
+    co_await CoroEventWait(event);
+    order.push_back(id);
+}
+
+TEST_F(JobManagerTest, CoroEventTriggeredBeforeWait)
+{
+    CoroEvent event;
+    event.Trigger();
+    EXPECT_TRUE(event.IsTriggered());
+
+    // Nothing to wait for, so the waiter isn't queued and the coroutine never suspends
+    CoroWaitNode node;
+    EXPECT_FALSE(event.TryEnqueueWaiter(&node));
+
+    Vector<int> order;
+    CoroBundle<void> jobs;
+    jobs.PushJob(WaitAndRecord(event, order, 0));
+    EXPECT_TRUE(jobs.IsComplete());
+    EXPECT_EQ(order.size(), 1u);
+}
+
+TEST_F(JobManagerTest, CoroEventResumesWaitersInOrder)
+{
+    CoroEvent event;
+    Vector<int> order;
+    CoroBundle<void> jobs;
+
+    // Started from the main thread, each waiter runs inline up to the wait and resumes inline on Trigger
+    for (int i = 0; i < 5; ++i)
+    {
+        jobs.PushJob(WaitAndRecord(event, order, i));
+    }
+    EXPECT_TRUE(order.empty());
+
+    event.Trigger();
+    jobs.WaitForCompletion();
+    EXPECT_EQ(order, (Vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+JobCoro<void> WaitAndCount(CoroEvent & event, std::atomic<int> & resumed)
+{
+    co_await CoroEventWait(event);
+    resumed.fetch_add(1, std::memory_order_acq_rel);
+}
+
+JobCoro<void> TriggerEvent(CoroEvent & event)
+{
+    event.Trigger();
+    co_return;
+}
+
+TEST_F(JobManagerTest, CoroEventWaitersRaceTrigger)
+{
+    for (int round = 0; round < 20; ++round)
+    {
+        CoroEvent event;
+        std::atomic<int> resumed{0};
+        CoroBundle<void> jobs;
+
+        // The trigger lands somewhere among the waiters, whether each one queued in time or not it must resume
+        for (int i = 0; i < 100; ++i)
+        {
+            if (i == 50)
+            {
+                jobs.PushJob(TriggerEvent(event));
+            }
+            jobs.PushJob(WaitAndCount(event, resumed));
+        }
+        jobs.WaitForCompletion();
+
+        EXPECT_EQ(resumed.load(), 100);
+        EXPECT_TRUE(event.IsTriggered());
+    }
+}
+
+TEST_F(JobManagerTest, CoroEventResetOnlyRearmsTriggered)
+{
+    CoroEvent event;
+    Vector<int> order;
+    CoroBundle<void> jobs;
+
+    // Waiters queued on an untriggered event survive a Reset
+    jobs.PushJob(WaitAndRecord(event, order, 0));
+    event.Reset();
+    EXPECT_FALSE(event.IsTriggered());
+    EXPECT_TRUE(order.empty());
+
+    event.Trigger();
+    EXPECT_EQ(order.size(), 1u);
+
+    // A triggered event is rearmed, new waiters suspend until the next Trigger
+    event.Reset();
+    EXPECT_FALSE(event.IsTriggered());
+
+    jobs.PushJob(WaitAndRecord(event, order, 1));
+    EXPECT_EQ(order.size(), 1u);
+
+    event.Trigger();
+    jobs.WaitForCompletion();
+    EXPECT_EQ(order, (Vector<int>{ 0, 1 }));
+}
+
+// Blocks its job thread on children that land on that thread's own deque, behind the job that is waiting
+JobCoro<int> BlockOnOwnChildren(int num_children)
+{
+    std::atomic<int> counter{0};
+    CoroBundle<void> children;
+    for (int i = 0; i < num_children; ++i)
+    {
+        children.PushJob(IncrementCounter(counter));
+    }
+
+    children.WaitForCompletion();
+    co_return counter.load();
+}
+
+JobCoro<int> RunOwnChildrenSynchronously(int num_children)
+{
+    std::atomic<int> counter{0};
+    for (int i = 0; i < num_children; ++i)
+    {
+        JobCoro<void> child = IncrementCounter(counter);
+        child.RunSynchronous();
+    }
+
+    co_return counter.load();
+}
+
+TEST_F(JobManagerTest, JobWaitingOnOwnChildrenCompletes)
+{
+    // More blocked parents than job threads, so nobody is left idle to steal the children for them
+    const int num_parents = g_JobManager->GetNumJobThreads() * 4;
+    CoroBundle<int> parents;
+    for (int i = 0; i < num_parents; ++i)
+    {
+        parents.PushJob(BlockOnOwnChildren(16));
+    }
+    parents.WaitForCompletion();
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(num_parents); ++i)
+    {
+        EXPECT_EQ(parents[i], 16);
+    }
+}
+
+TEST_F(JobManagerTest, JobRunningOwnChildrenSynchronouslyCompletes)
+{
+    const int num_parents = g_JobManager->GetNumJobThreads() * 4;
+    CoroBundle<int> parents;
+    for (int i = 0; i < num_parents; ++i)
+    {
+        parents.PushJob(RunOwnChildrenSynchronously(16));
+    }
+    parents.WaitForCompletion();
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(num_parents); ++i)
+    {
+        EXPECT_EQ(parents[i], 16);
+    }
+}
+
+// Spins on its job thread until released, keeping that thread away from everyone else's jobs
+JobCoro<void> HoldJobThread(std::atomic<bool> & held, const std::atomic<bool> & release)
+{
+    held.store(true, std::memory_order_release);
+    while (!release.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+    co_return;
+}
+
+// One job thread besides the main thread, held busy, so jobs the test queues sit still until it runs them one at a time
+class HeldJobThreadTest : public JobManagerTest
+{
+protected:
+    void SetUp() override
+    {
+        JobManagerTest::SetUp();
+
+        // A single thread pool runs jobs inline as they're pushed, so take two and hold the second
+        g_JobManager->StopRunningJobs();
+        g_JobManager = MakeUnique<JobManager>(2);
+        g_JobManager->PrepareToRunJobs();
+
+        m_Holder.PushJob(HoldJobThread(m_Held, m_Release));
+        while (!m_Held.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void TearDown() override
+    {
+        m_Release.store(true, std::memory_order_release);
+        m_Holder.WaitForCompletion();
+
+        JobManagerTest::TearDown();
+
+        // Put the regular pool back for the tests that follow
+        g_JobManager.reset();
+        JobManager::CreateJobManager();
+    }
+
+    std::atomic<bool> m_Held{false};
+    std::atomic<bool> m_Release{false};
+    CoroBundle<void> m_Holder;
+};
+
+JobCoro<void> RecordPriority(Vector<JobPriority> & order, JobPriority priority)
+{
+    order.push_back(priority);
+    co_return;
+}
+
+TEST_F(HeldJobThreadTest, HigherLanesRunFirst)
+{
+    Vector<JobPriority> order;
+    CoroBundle<void> jobs;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        jobs.PushJob(RecordPriority(order, JobPriority::Idle).WithPriority(JobPriority::Idle));
+        jobs.PushJob(RecordPriority(order, JobPriority::Normal).WithPriority(JobPriority::Normal));
+        jobs.PushJob(RecordPriority(order, JobPriority::FrameCritical).WithPriority(JobPriority::FrameCritical));
+    }
+    EXPECT_TRUE(order.empty());
+
+    while (g_JobManager->TryRunPendingJob()) {}
+    EXPECT_TRUE(jobs.IsComplete());
+
+    const Vector<JobPriority> expected =
+    {
+        JobPriority::FrameCritical, JobPriority::FrameCritical, JobPriority::FrameCritical,
+        JobPriority::Normal, JobPriority::Normal, JobPriority::Normal,
+        JobPriority::Idle, JobPriority::Idle, JobPriority::Idle,
+    };
+    EXPECT_EQ(order, expected);
+}
+
+TEST_F(HeldJobThreadTest, IdleLaneIsPromotedAfterStarvationLimit)
+{
+    Vector<JobPriority> order;
+    CoroBundle<void> jobs;
+
+    const int num_higher = JobManager::IdleLaneStarvationLimit + 8;
+    jobs.PushJob(RecordPriority(order, JobPriority::Idle).WithPriority(JobPriority::Idle));
+    for (int i = 0; i < num_higher; ++i)
+    {
+        jobs.PushJob(RecordPriority(order, JobPriority::Normal).WithPriority(JobPriority::Normal));
+    }
+
+    while (g_JobManager->TryRunPendingJob()) {}
+    EXPECT_TRUE(jobs.IsComplete());
+
+    // The idle job jumps the queue straight after the limit instead of waiting for the normal lane to empty
+    ASSERT_EQ(order.size(), static_cast<std::size_t>(num_higher + 1));
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const bool promoted = i == static_cast<std::size_t>(JobManager::IdleLaneStarvationLimit);
+        EXPECT_EQ(order[i], promoted ? JobPriority::Idle : JobPriority::Normal);
+    }
+    EXPECT_EQ(g_JobManager->GetStats().m_IdleLanePromotions, 1u);
+}
+
+JobCoro<void> SetFlag(std::atomic<bool> & flag)
+{
+    flag.store(true, std::memory_order_release);
+    co_return;
+}
+
+TEST_F(JobManagerTest, ParkedThreadIsWokenForNewJob)
+{
+    if (g_JobManager->GetNumJobThreads() < 2)
+    {
+        GTEST_SKIP() << "Needs a job thread besides the main thread";
+    }
+
+    // Give every job thread time to spin, nap and end up parked on its futex
+    const int num_job_threads = g_JobManager->GetNumJobThreads() - 1;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (g_JobManager->GetStats().m_Parks < static_cast<std::uint64_t>(num_job_threads) &&
+        std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const JobManagerStats before = g_JobManager->GetStats();
+    ASSERT_GT(before.m_Parks, 0u);
+
+    // Wait without helping, so the job only runs if a parked thread is woken to steal it
+    std::atomic<bool> ran{false};
+    CoroBundle<void> jobs;
+    jobs.PushJob(SetFlag(ran));
+    while (!ran.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_TRUE(ran.load());
+    jobs.WaitForCompletion();
+    EXPECT_GT(g_JobManager->GetStats().m_FutexWakeups, before.m_FutexWakeups);
+}
+
+TEST_F(JobManagerTest, BackgroundBulkPushRunsEveryItem)
+{
+    // Bigger than the ring, so part of the batch spills and has to be picked up all the same
+    const int num_items = 10000;
+    std::atomic<int> counter{0};
+
+    Vector<WorkFunction> work;
+    work.reserve(num_items);
+    for (int i = 0; i < num_items; ++i)
+    {
+        work.emplace_back([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+    }
+
+    g_BackgroundTaskManager->PushWork(Span<WorkFunction>(work));
+    g_BackgroundTaskManager->SyncAll();
+    EXPECT_EQ(counter.load(), num_items);
+
+    // An empty batch queues and signals nothing, SyncAll still returns straight away
+    g_BackgroundTaskManager->PushWork(Span<WorkFunction>());
+    g_BackgroundTaskManager->SyncAll();
+    EXPECT_EQ(counter.load(), num_items);
+}
+
 // Performance tests
 TEST_F(JobManagerTest, JobThroughput)
 {
     const int num_jobs = 100000;
     std::atomic<int> counter{0};
-    JobList<void> jobs;
+    CoroBundle<void> jobs;
     jobs.Reserve(num_jobs);
 
     auto start_time = std::chrono::high_resolution_clock::now();
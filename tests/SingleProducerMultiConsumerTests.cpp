@@ -1,7 +1,10 @@
 module;
 
 #include <gtest/gtest.h>
+#include <array>
 #include <atomic>
+#include <iterator>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -176,6 +179,147 @@ namespace YT
             EXPECT_EQ(seen[static_cast<std::size_t>(i)].load(std::memory_order_relaxed), 1);
         }
     }
+
+    TEST_F(SingleProducerMultiConsumerTest, BulkPartialAndWraparound)
+    {
+        SingleProducerMultiConsumer<int, 4> queue;
+
+        std::array<int, 6> values = { 1, 2, 3, 4, 5, 6 };
+        EXPECT_EQ(queue.TryEnqueueBulk(std::span<int>(values)), 4u);
+        EXPECT_TRUE(queue.Full());
+        EXPECT_EQ(queue.TryEnqueueBulk(std::span<int>(values).subspan(4)), 0u);
+
+        std::array<int, 8> out = {};
+        EXPECT_EQ(queue.TryDequeueBulk(out.data(), 3), 3u);
+        EXPECT_EQ(out[0], 1);
+        EXPECT_EQ(out[1], 2);
+        EXPECT_EQ(out[2], 3);
+
+        // The rest wraps around the end of the ring
+        EXPECT_EQ(queue.TryEnqueueBulk(std::span<int>(values).subspan(4)), 2u);
+        EXPECT_EQ(queue.Size(), 3u);
+
+        std::vector<int> rest;
+        EXPECT_EQ(queue.TryDequeueBulk(std::back_inserter(rest), out.size()), 3u);
+        EXPECT_EQ(rest, (std::vector<int>{ 4, 5, 6 }));
+
+        EXPECT_EQ(queue.TryDequeueBulk(out.data(), out.size()), 0u);
+        EXPECT_TRUE(queue.Empty());
+    }
+
+    TEST_F(SingleProducerMultiConsumerTest, BulkMovesAndDestroysValues)
+    {
+        LifetimeTracked::Reset();
+        {
+            SingleProducerMultiConsumer<LifetimeTracked, 8> queue;
+
+            std::vector<LifetimeTracked> values;
+            for (int i = 0; i < 5; ++i)
+            {
+                values.emplace_back(i);
+            }
+
+            EXPECT_EQ(queue.TryEnqueueBulk(std::span<LifetimeTracked>(values)), 5u);
+
+            std::array<LifetimeTracked, 5> out;
+            const int destroyed_before = LifetimeTracked::destructor_count.load(std::memory_order_relaxed);
+            EXPECT_EQ(queue.TryDequeueBulk(out.data(), out.size()), 5u);
+            EXPECT_EQ(LifetimeTracked::destructor_count.load(std::memory_order_relaxed) - destroyed_before, 5);
+
+            for (int i = 0; i < 5; ++i)
+            {
+                EXPECT_EQ(out[static_cast<std::size_t>(i)].value, i);
+            }
+        }
+    }
+
+    TEST_F(SingleProducerMultiConsumerTest, BulkConcurrency)
+    {
+        constexpr int producer_count = 1;
+        constexpr int consumer_count = 4;
+        constexpr int values_per_producer = 10000;
+        constexpr int total_values = producer_count * values_per_producer;
+        constexpr std::size_t producer_batch = 8;
+        constexpr std::size_t consumer_batch = 16;
+
+        SingleProducerMultiConsumer<int, 256> queue;
+        std::vector<std::atomic<int>> seen(static_cast<std::size_t>(total_values));
+        for (auto & value : seen)
+        {
+            value.store(0, std::memory_order_relaxed);
+        }
+
+        std::atomic<int> consumed_count = 0;
+        std::atomic<int> producers_finished = 0;
+
+        std::vector<std::thread> threads;
+        for (int producer_index = 0; producer_index < producer_count; ++producer_index)
+        {
+            threads.emplace_back([&queue, producer_index, &producers_finished]()
+            {
+                std::array<int, producer_batch> batch = {};
+                for (int start = producer_index * values_per_producer; start < (producer_index + 1) * values_per_producer; start += producer_batch)
+                {
+                    for (std::size_t i = 0; i < producer_batch; ++i)
+                    {
+                        batch[i] = start + static_cast<int>(i);
+                    }
+
+                    std::size_t sent = 0;
+                    while (sent < producer_batch)
+                    {
+                        sent += queue.TryEnqueueBulk(std::span<int>(batch).subspan(sent));
+                        std::this_thread::yield();
+                    }
+                }
+
+                producers_finished.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        for (int consumer_index = 0; consumer_index < consumer_count; ++consumer_index)
+        {
+            threads.emplace_back([&queue, &seen, &consumed_count, &producers_finished]()
+            {
+                std::array<int, consumer_batch> batch = {};
+                while (true)
+                {
+                    const std::size_t count = queue.TryDequeueBulk(batch.data(), batch.size());
+                    if (count != 0)
+                    {
+                        for (std::size_t i = 0; i < count; ++i)
+                        {
+                            ASSERT_TRUE(batch[i] >= 0 && batch[i] < total_values);
+                            seen[static_cast<std::size_t>(batch[i])].fetch_add(1, std::memory_order_relaxed);
+                        }
+
+                        consumed_count.fetch_add(static_cast<int>(count), std::memory_order_release);
+                        continue;
+                    }
+
+                    if (producers_finished.load(std::memory_order_acquire) == producer_count &&
+                        queue.Empty())
+                    {
+                        return;
+                    }
+
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ(consumed_count.load(std::memory_order_acquire), total_values);
+        EXPECT_TRUE(queue.Empty());
+        for (int i = 0; i < total_values; ++i)
+        {
+            EXPECT_EQ(seen[static_cast<std::size_t>(i)].load(std::memory_order_relaxed), 1);
+        }
+    }
 }
 
 int main(int argc, char **argv)
@@ -0,0 +1,262 @@
+module;
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+export module YT:SpillQueueTests;
+
+import :SpillQueue;
+import :MultiProducerMultiConsumer;
+import :MultiProducerSingleConsumer;
+
+namespace YT
+{
+    class SpillQueueTest : public ::testing::Test
+    {
+    };
+
+    TEST_F(SpillQueueTest, StaysInRingUntilFull)
+    {
+        SpillQueue<int, 4> queue;
+
+        EXPECT_TRUE(queue.Empty());
+        for (int i = 0; i < 4; ++i)
+        {
+            queue.Enqueue(int{ i });
+        }
+
+        EXPECT_EQ(queue.Size(), 4u);
+        EXPECT_EQ(queue.SpillSize(), 0u);
+        EXPECT_EQ(queue.GetStats().m_Spills, 0u);
+    }
+
+    TEST_F(SpillQueueTest, OverflowSpillsAndKeepsOrder)
+    {
+        SpillQueue<int, 4> queue;
+
+        constexpr int NumItems = 1000;
+        for (int i = 0; i < NumItems; ++i)
+        {
+            queue.Enqueue(int{ i });
+        }
+
+        EXPECT_EQ(queue.Size(), static_cast<std::size_t>(NumItems));
+        EXPECT_EQ(queue.SpillSize(), static_cast<std::size_t>(NumItems - 4));
+
+        const SpillQueueStats stats = queue.GetStats();
+        EXPECT_EQ(stats.m_Spills, static_cast<std::uint64_t>(NumItems - 4));
+        EXPECT_EQ(stats.m_HighWater, static_cast<std::uint64_t>(NumItems - 4));
+
+        int value = -1;
+        for (int i = 0; i < NumItems; ++i)
+        {
+            ASSERT_TRUE(queue.TryDequeue(value));
+            EXPECT_EQ(value, i);
+        }
+
+        EXPECT_FALSE(queue.TryDequeue(value));
+        EXPECT_TRUE(queue.Empty());
+    }
+
+    TEST_F(SpillQueueTest, ReusesRingAfterSpillDrains)
+    {
+        SpillQueue<int, 2> queue;
+
+        for (int round = 0; round < 3; ++round)
+        {
+            for (int i = 0; i < 600; ++i)
+            {
+                queue.Enqueue(int{ i });
+            }
+
+            int value = -1;
+            for (int i = 0; i < 600; ++i)
+            {
+                ASSERT_TRUE(queue.TryDequeue(value));
+                EXPECT_EQ(value, i);
+            }
+
+            EXPECT_TRUE(queue.Empty());
+        }
+
+        EXPECT_EQ(queue.GetStats().m_HighWater, 598u);
+        EXPECT_EQ(queue.GetStats().m_Spills, 3u * 598u);
+    }
+
+    TEST_F(SpillQueueTest, BulkOverflowSpillsAndKeepsOrder)
+    {
+        SpillQueue<int, 8> queue;
+
+        std::vector<int> values(100);
+        for (int i = 0; i < 100; ++i)
+        {
+            values[static_cast<std::size_t>(i)] = i;
+        }
+
+        queue.EnqueueBulk(std::span<int>(values).first(5));
+        EXPECT_EQ(queue.SpillSize(), 0u);
+
+        queue.EnqueueBulk(std::span<int>(values).subspan(5));
+        EXPECT_EQ(queue.Size(), 100u);
+        EXPECT_EQ(queue.SpillSize(), 92u);
+
+        std::vector<int> out;
+        while (queue.TryDequeueBulk(std::back_inserter(out), 16) != 0)
+        {
+        }
+
+        EXPECT_EQ(out, values);
+        EXPECT_TRUE(queue.Empty());
+    }
+
+    TEST_F(SpillQueueTest, MoveOnlyElements)
+    {
+        SpillQueue<std::unique_ptr<int>, 2> queue;
+
+        for (int i = 0; i < 10; ++i)
+        {
+            queue.Enqueue(std::make_unique<int>(i));
+        }
+
+        std::unique_ptr<int> value;
+        for (int i = 0; i < 10; ++i)
+        {
+            ASSERT_TRUE(queue.TryDequeue(value));
+            ASSERT_TRUE(value);
+            EXPECT_EQ(*value, i);
+        }
+    }
+
+    TEST_F(SpillQueueTest, ConcurrentProducersMultipleConsumers)
+    {
+        SpillQueue<int, 16> queue;
+
+        constexpr int NumProducers = 4;
+        constexpr int NumConsumers = 3;
+        constexpr int ItemsPerProducer = 20000;
+
+        std::atomic<int> consumed = 0;
+        std::atomic<std::int64_t> sum = 0;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < NumProducers; ++p)
+        {
+            threads.emplace_back([&queue, p]
+            {
+                for (int i = 0; i < ItemsPerProducer; ++i)
+                {
+                    queue.Enqueue(int{ p * ItemsPerProducer + i });
+                }
+            });
+        }
+
+        for (int c = 0; c < NumConsumers; ++c)
+        {
+            threads.emplace_back([&]
+            {
+                int value = 0;
+                while (consumed.load(std::memory_order_relaxed) < NumProducers * ItemsPerProducer)
+                {
+                    if (queue.TryDequeue(value))
+                    {
+                        sum.fetch_add(value, std::memory_order_relaxed);
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+
+        for (std::thread & thread : threads)
+        {
+            thread.join();
+        }
+
+        constexpr std::int64_t Total = NumProducers * ItemsPerProducer;
+        EXPECT_EQ(consumed.load(), Total);
+        EXPECT_EQ(sum.load(), Total * (Total - 1) / 2);
+        EXPECT_TRUE(queue.Empty());
+    }
+
+    TEST_F(SpillQueueTest, ContendedProducersOnlySpillWhenFull)
+    {
+        constexpr int NumProducers = 4;
+        constexpr int ItemsPerProducer = 8192;
+
+        // Room for everything, so losing a race for a slot must not be mistaken for a full ring
+        auto queue = std::make_unique<SpillQueue<int, NumProducers * ItemsPerProducer>>();
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < NumProducers; ++p)
+        {
+            threads.emplace_back([&queue, p]
+            {
+                for (int i = 0; i < ItemsPerProducer; ++i)
+                {
+                    queue->Enqueue(int{ p * ItemsPerProducer + i });
+                }
+            });
+        }
+
+        for (std::thread & thread : threads)
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ(queue->Size(), static_cast<std::size_t>(NumProducers * ItemsPerProducer));
+        EXPECT_EQ(queue->GetStats().m_Spills, 0u);
+    }
+
+    TEST_F(SpillQueueTest, ConcurrentProducersSingleConsumerKeepsPerProducerOrder)
+    {
+        SpillQueue<int, 8, MultiProducerSingleConsumer> queue;
+
+        constexpr int NumProducers = 4;
+        constexpr int ItemsPerProducer = 20000;
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < NumProducers; ++p)
+        {
+            producers.emplace_back([&queue, p]
+            {
+                for (int i = 0; i < ItemsPerProducer; ++i)
+                {
+                    queue.Enqueue(int{ p * ItemsPerProducer + i });
+                }
+            });
+        }
+
+        std::vector<int> last_seen(NumProducers, -1);
+        int consumed = 0;
+        int value = 0;
+        while (consumed < NumProducers * ItemsPerProducer)
+        {
+            if (queue.TryDequeue(value))
+            {
+                const int producer = value / ItemsPerProducer;
+                const int index = value % ItemsPerProducer;
+                EXPECT_GT(index, last_seen[producer]);
+                last_seen[producer] = index;
+                ++consumed;
+            }
+        }
+
+        for (std::thread & producer : producers)
+        {
+            producer.join();
+        }
+
+        EXPECT_TRUE(queue.Empty());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,143 @@
+module;
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+export module YT:ThreadTopologyTests;
+
+import :Types;
+import :ThreadTopology;
+
+namespace YT
+{
+    /// Builds a fake /sys/devices tree: 8 CPUs, 4 cores with 2 SMT siblings each, split over two L3 domains
+    class ThreadTopologyTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            m_Root = std::filesystem::temp_directory_path() / ("yt_topology_" + std::to_string(getpid()));
+            std::filesystem::remove_all(m_Root);
+
+            WriteFile("system/cpu/online", "0-7");
+            for (int cpu = 0; cpu < 8; ++cpu)
+            {
+                const std::string cpu_path = "system/cpu/cpu" + std::to_string(cpu);
+                WriteFile(cpu_path + "/topology/physical_package_id", "0");
+                WriteFile(cpu_path + "/topology/core_id", std::to_string(cpu % 4));
+                WriteFile(cpu_path + "/cache/index0/level", "1");
+                WriteFile(cpu_path + "/cache/index0/shared_cpu_list", std::to_string(cpu) + "," + std::to_string(cpu ^ 4));
+                WriteFile(cpu_path + "/cache/index1/level", "3");
+                WriteFile(cpu_path + "/cache/index1/shared_cpu_list", cpu % 4 < 2 ? "0-1,4-5" : "2-3,6-7");
+            }
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(m_Root);
+        }
+
+        void WriteFile(const std::string & relative_path, const std::string & contents)
+        {
+            const std::filesystem::path path = m_Root / relative_path;
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path) << contents << "\n";
+        }
+
+        std::filesystem::path m_Root;
+    };
+
+    TEST_F(ThreadTopologyTest, ParsesCpuLists)
+    {
+        EXPECT_EQ(ParseCpuList("0-3,8,10-11\n"), (Vector<int>{ 0, 1, 2, 3, 8, 10, 11 }));
+        EXPECT_EQ(ParseCpuList("5"), (Vector<int>{ 5 }));
+        EXPECT_TRUE(ParseCpuList("").empty());
+    }
+
+    TEST_F(ThreadTopologyTest, FindsL3Domains)
+    {
+        const ThreadTopology topology = ThreadTopology::Probe(m_Root.string());
+
+        ASSERT_EQ(topology.GetCpus().size(), 8u);
+        EXPECT_EQ(topology.GetNumL3Domains(), 2u);
+        EXPECT_FALSE(topology.IsHybrid());
+        EXPECT_EQ(topology.GetCpus()[5].m_L3Domain, 0);
+        EXPECT_EQ(topology.GetCpus()[6].m_L3Domain, 2);
+    }
+
+    TEST_F(ThreadTopologyTest, PackL3FillsOneDomainFirst)
+    {
+        const ThreadTopology topology = ThreadTopology::Probe(m_Root.string());
+
+        // One sibling per core before the second siblings, then the next domain
+        EXPECT_EQ(topology.SelectCpus(ThreadAffinityPolicy::PackL3), (Vector<int>{ 0, 1, 4, 5, 2, 3, 6, 7 }));
+        EXPECT_TRUE(topology.SelectCpus(ThreadAffinityPolicy::None).empty());
+    }
+
+    TEST_F(ThreadTopologyTest, PackL3PoolsTakeSeparateCpus)
+    {
+        const ThreadTopology topology = ThreadTopology::Probe(m_Root.string());
+
+        ApplicationInitInfo init_info;
+        init_info.m_ThreadPoolSize = 3;
+        init_info.m_BackgroundThreadPoolSize = 2;
+        init_info.m_FileMapperThreadPoolSize = 2;
+        init_info.m_JobThreadAffinity = ThreadAffinityPolicy::PackL3;
+        init_info.m_BackgroundThreadAffinity = ThreadAffinityPolicy::None;
+        init_info.m_FileMapperThreadAffinity = ThreadAffinityPolicy::PackL3;
+        Threading::Configure(init_info);
+
+        // Job threads take slots 0-2, the background pool isn't pinned, file mapper threads carry on from slot 3
+        EXPECT_EQ(topology.SelectThreadCpus(ThreadPoolType::Job, 1), (Vector<int>{ 1 }));
+        EXPECT_EQ(topology.SelectThreadCpus(ThreadPoolType::Job, 2), (Vector<int>{ 4 }));
+        EXPECT_TRUE(topology.SelectThreadCpus(ThreadPoolType::Background, 0).empty());
+        EXPECT_EQ(topology.SelectThreadCpus(ThreadPoolType::FileMapper, 0), (Vector<int>{ 5 }));
+        EXPECT_EQ(topology.SelectThreadCpus(ThreadPoolType::FileMapper, 1), (Vector<int>{ 2 }));
+
+        // The main thread floats over the job pool's slots rather than owning one
+        EXPECT_EQ(topology.SelectPoolCpus(ThreadPoolType::Job), (Vector<int>{ 0, 1, 4 }));
+
+        Threading::Configure(ApplicationInitInfo{});
+    }
+
+    TEST_F(ThreadTopologyTest, ClassifiesHybridCores)
+    {
+        WriteFile("cpu_core/cpus", "2-3,6-7");
+        WriteFile("cpu_atom/cpus", "0-1,4-5");
+
+        const ThreadTopology topology = ThreadTopology::Probe(m_Root.string());
+
+        EXPECT_TRUE(topology.IsHybrid());
+        EXPECT_EQ(topology.SelectCpus(ThreadAffinityPolicy::PerformanceCores), (Vector<int>{ 2, 3, 6, 7 }));
+        EXPECT_EQ(topology.SelectCpus(ThreadAffinityPolicy::EfficiencyCores), (Vector<int>{ 0, 1, 4, 5 }));
+
+        // The domain holding the performance cores now goes first
+        EXPECT_EQ(topology.SelectCpus(ThreadAffinityPolicy::PackL3), (Vector<int>{ 2, 3, 6, 7, 0, 1, 4, 5 }));
+    }
+
+    TEST_F(ThreadTopologyTest, NonHybridCoreTypePoliciesUseEveryCpu)
+    {
+        const ThreadTopology topology = ThreadTopology::Probe(m_Root.string());
+
+        EXPECT_EQ(topology.SelectCpus(ThreadAffinityPolicy::EfficiencyCores).size(), 8u);
+    }
+
+    TEST_F(ThreadTopologyTest, MissingSysfsGivesEmptyTopology)
+    {
+        const ThreadTopology topology = ThreadTopology::Probe((m_Root / "missing").string());
+
+        EXPECT_TRUE(topology.GetCpus().empty());
+        EXPECT_TRUE(topology.SelectCpus(ThreadAffinityPolicy::PackL3).empty());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
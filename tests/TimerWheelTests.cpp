@@ -0,0 +1,145 @@
+module;
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+export module YT:TimerWheelTests;
+
+import :TimerWheel;
+
+namespace YT
+{
+    struct TestTimer : TimerWheelNode
+    {
+        std::uint64_t m_FiredAt = 0;
+        int m_FireCount = 0;
+    };
+
+    std::uint64_t g_TestNow = 0;
+
+    void OnTestTimerExpire(TimerWheelNode & node) noexcept
+    {
+        TestTimer & timer = static_cast<TestTimer &>(node);
+        timer.m_FiredAt = g_TestNow;
+        ++timer.m_FireCount;
+    }
+
+    class TimerWheelTest : public ::testing::Test
+    {
+    protected:
+        void Schedule(TimerWheel & wheel, TestTimer & timer, std::uint64_t expiry_tick)
+        {
+            timer.m_ExpiryTick = expiry_tick;
+            timer.m_OnExpire = &OnTestTimerExpire;
+            wheel.Schedule(timer);
+        }
+
+        std::size_t AdvanceTo(TimerWheel & wheel, std::uint64_t tick)
+        {
+            g_TestNow = tick;
+            return wheel.Advance(tick);
+        }
+    };
+
+    TEST_F(TimerWheelTest, FiresOnExpiryTick)
+    {
+        TimerWheel wheel;
+        TestTimer timer;
+        Schedule(wheel, timer, 10);
+
+        EXPECT_EQ(AdvanceTo(wheel, 9), 0u);
+        EXPECT_EQ(timer.m_FireCount, 0);
+        EXPECT_EQ(wheel.GetNumPendingTimers(), 1u);
+
+        EXPECT_EQ(AdvanceTo(wheel, 10), 1u);
+        EXPECT_EQ(timer.m_FireCount, 1);
+        EXPECT_EQ(wheel.GetNumPendingTimers(), 0u);
+
+        AdvanceTo(wheel, 1000);
+        EXPECT_EQ(timer.m_FireCount, 1);
+    }
+
+    TEST_F(TimerWheelTest, AlreadyDueFiresOnNextAdvance)
+    {
+        TimerWheel wheel(100);
+        TestTimer timer;
+        Schedule(wheel, timer, 50);
+
+        EXPECT_EQ(AdvanceTo(wheel, 100), 1u);
+        EXPECT_EQ(timer.m_FireCount, 1);
+    }
+
+    TEST_F(TimerWheelTest, CascadesFromUpperLevels)
+    {
+        TimerWheel wheel;
+        std::vector<TestTimer> timers(4);
+        const std::uint64_t expiries[] = { 300, 20000, 3000000, 70000000 };
+
+        for (std::size_t index = 0; index < timers.size(); ++index)
+        {
+            Schedule(wheel, timers[index], expiries[index]);
+        }
+
+        for (std::size_t index = 0; index < timers.size(); ++index)
+        {
+            AdvanceTo(wheel, expiries[index] - 1);
+            EXPECT_EQ(timers[index].m_FireCount, 0);
+
+            AdvanceTo(wheel, expiries[index]);
+            EXPECT_EQ(timers[index].m_FireCount, 1);
+            EXPECT_EQ(timers[index].m_FiredAt, expiries[index]);
+        }
+    }
+
+    TEST_F(TimerWheelTest, BeyondRangeStillFires)
+    {
+        TimerWheel wheel;
+        TestTimer timer;
+        const std::uint64_t expiry = TimerWheel::MaxRange * 3 + 17;
+        Schedule(wheel, timer, expiry);
+
+        AdvanceTo(wheel, expiry - 1);
+        EXPECT_EQ(timer.m_FireCount, 0);
+
+        AdvanceTo(wheel, expiry);
+        EXPECT_EQ(timer.m_FireCount, 1);
+    }
+
+    TEST_F(TimerWheelTest, RandomTimersFireExactlyOnceAndNeverEarly)
+    {
+        std::mt19937_64 rng(1234);
+        TimerWheel wheel(rng() % 100000);
+        std::vector<TestTimer> timers(2000);
+
+        const std::uint64_t start = wheel.GetCurrentTick();
+        for (TestTimer & timer : timers)
+        {
+            const std::uint64_t ranges[] = { 300, 20000, 2000000, 1ull << 27 };
+            Schedule(wheel, timer, start + rng() % ranges[rng() % 4]);
+        }
+
+        std::uint64_t now = start;
+        std::size_t fired = 0;
+        while (fired < timers.size())
+        {
+            // Mostly frame sized steps with the odd long stall
+            now += 1 + rng() % (rng() % 10 == 0 ? 100000 : 50);
+            fired += AdvanceTo(wheel, now);
+        }
+
+        for (const TestTimer & timer : timers)
+        {
+            EXPECT_EQ(timer.m_FireCount, 1);
+            EXPECT_GE(timer.m_FiredAt, timer.m_ExpiryTick);
+        }
+        EXPECT_EQ(wheel.GetNumPendingTimers(), 0u);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+module;
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+export module YT:WaitTests;
+
+import :Wait;
+
+namespace YT
+{
+    class WaitTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            InitWait();
+        }
+    };
+
+    TEST_F(WaitTest, ReturnsStraightAwayIfAlreadyChanged)
+    {
+        std::atomic<std::uint32_t> value = 1;
+
+        EXPECT_TRUE(AtomicWait(value, 0u));
+        EXPECT_TRUE(AtomicWait(value, 0u, AtomicWaitBoundedPolicy));
+    }
+
+    TEST_F(WaitTest, BoundedPolicyGivesUp)
+    {
+        std::atomic<std::uint32_t> value = 0;
+
+        EXPECT_FALSE(AtomicWait(value, 0u, AtomicWaitBoundedPolicy));
+        EXPECT_EQ(value.load(), 0u);
+    }
+
+    TEST_F(WaitTest, NotifyWakesParkedWaiter)
+    {
+        std::atomic<std::uint32_t> value = 0;
+        std::atomic<bool> woken = false;
+
+        std::thread waiter([&]
+        {
+            while (value.load(std::memory_order_acquire) == 0)
+            {
+                AtomicWait(value, 0u, AtomicWaitParkPolicy);
+            }
+            woken.store(true, std::memory_order_release);
+        });
+
+        // Long enough for the waiter to get past the spin and monitor stages and park on the futex
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(woken.load());
+
+        value.store(1, std::memory_order_release);
+        AtomicNotify(value);
+        waiter.join();
+
+        EXPECT_TRUE(woken.load());
+    }
+
+    TEST_F(WaitTest, BoundedWaiterSeesChangeFromAnotherThread)
+    {
+        std::atomic<std::uint32_t> value = 0;
+
+        std::thread writer([&]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            value.store(1, std::memory_order_release);
+        });
+
+        // Nobody notifies, the bounded waiter finds the change by re-checking
+        while (!AtomicWait(value, 0u, AtomicWaitBoundedPolicy)) {}
+        EXPECT_EQ(value.load(), 1u);
+
+        writer.join();
+    }
+
+    TEST_F(WaitTest, NotifyWithoutWaitersIsHarmless)
+    {
+        std::atomic<std::uint32_t> value = 0;
+        AtomicNotify(value);
+
+        value.store(2, std::memory_order_release);
+        AtomicNotify(value);
+        EXPECT_TRUE(AtomicWait(value, 0u));
+    }
+}
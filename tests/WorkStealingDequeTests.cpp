@@ -0,0 +1,181 @@
+module;
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+export module YT:WorkStealingDequeTests;
+
+import :WorkStealingDeque;
+
+namespace YT
+{
+    class WorkStealingDequeTest : public ::testing::Test
+    {
+    };
+
+    TEST_F(WorkStealingDequeTest, PopIsLastInFirstOut)
+    {
+        WorkStealingDeque<int, 8> deque;
+
+        EXPECT_TRUE(deque.Empty());
+        EXPECT_TRUE(deque.Push(1));
+        EXPECT_TRUE(deque.Push(2));
+        EXPECT_TRUE(deque.Push(3));
+        EXPECT_EQ(deque.Size(), 3u);
+
+        int value = 0;
+        EXPECT_TRUE(deque.Pop(value));
+        EXPECT_EQ(value, 3);
+        EXPECT_TRUE(deque.Pop(value));
+        EXPECT_EQ(value, 2);
+        EXPECT_TRUE(deque.Pop(value));
+        EXPECT_EQ(value, 1);
+
+        EXPECT_FALSE(deque.Pop(value));
+        EXPECT_TRUE(deque.Empty());
+    }
+
+    TEST_F(WorkStealingDequeTest, StealIsFirstInFirstOut)
+    {
+        WorkStealingDeque<int, 8> deque;
+
+        EXPECT_TRUE(deque.Push(1));
+        EXPECT_TRUE(deque.Push(2));
+        EXPECT_TRUE(deque.Push(3));
+
+        int value = 0;
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 1);
+        EXPECT_TRUE(deque.Pop(value));
+        EXPECT_EQ(value, 3);
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 2);
+
+        EXPECT_FALSE(deque.Steal(value));
+        EXPECT_FALSE(deque.Pop(value));
+    }
+
+    TEST_F(WorkStealingDequeTest, FullAndWraparound)
+    {
+        WorkStealingDeque<int, 4> deque;
+
+        EXPECT_TRUE(deque.Push(10));
+        EXPECT_TRUE(deque.Push(11));
+        EXPECT_TRUE(deque.Push(12));
+        EXPECT_TRUE(deque.Push(13));
+        EXPECT_FALSE(deque.Push(99));
+        EXPECT_EQ(deque.Size(), deque.MaxSize());
+
+        int value = 0;
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 10);
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 11);
+
+        EXPECT_TRUE(deque.Push(20));
+        EXPECT_TRUE(deque.Push(21));
+        EXPECT_FALSE(deque.Push(99));
+
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 12);
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 13);
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 20);
+        EXPECT_TRUE(deque.Steal(value));
+        EXPECT_EQ(value, 21);
+        EXPECT_FALSE(deque.Steal(value));
+    }
+
+    TEST_F(WorkStealingDequeTest, OwnerAndThievesConcurrency)
+    {
+        constexpr int thief_count = 4;
+        constexpr int total_values = 100000;
+
+        WorkStealingDeque<int, 1024> deque;
+        std::vector<std::atomic<int>> seen(static_cast<std::size_t>(total_values));
+        for (auto & value : seen)
+        {
+            value.store(0, std::memory_order_relaxed);
+        }
+
+        std::atomic<bool> owner_finished = false;
+
+        std::vector<std::thread> thieves;
+        thieves.reserve(thief_count);
+
+        for (int thief_index = 0; thief_index < thief_count; ++thief_index)
+        {
+            thieves.emplace_back([&deque, &seen, &owner_finished]()
+            {
+                while (true)
+                {
+                    int value = 0;
+                    if (deque.Steal(value))
+                    {
+                        ASSERT_GE(value, 0);
+                        ASSERT_LT(value, total_values);
+                        seen[static_cast<std::size_t>(value)].fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (owner_finished.load(std::memory_order_acquire))
+                    {
+                        return;
+                    }
+
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        for (int value = 0; value < total_values; ++value)
+        {
+            while (!deque.Push(value))
+            {
+                int popped = 0;
+                if (deque.Pop(popped))
+                {
+                    seen[static_cast<std::size_t>(popped)].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // Interleave owner pops so the last-element race with thieves is exercised
+            if ((value & 7) == 0)
+            {
+                int popped = 0;
+                if (deque.Pop(popped))
+                {
+                    seen[static_cast<std::size_t>(popped)].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        int popped = 0;
+        while (deque.Pop(popped))
+        {
+            seen[static_cast<std::size_t>(popped)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        owner_finished.store(true, std::memory_order_release);
+
+        for (auto & thief : thieves)
+        {
+            thief.join();
+        }
+
+        EXPECT_TRUE(deque.Empty());
+        for (int i = 0; i < total_values; ++i)
+        {
+            EXPECT_EQ(seen[static_cast<std::size_t>(i)].load(std::memory_order_relaxed), 1);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
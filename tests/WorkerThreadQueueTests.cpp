@@ -0,0 +1,106 @@
+module;
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+export module YT:WorkerThreadQueueTests;
+
+import :Types;
+import :JobTypes;
+import :WorkerThreadQueue;
+
+namespace YT
+{
+    class WorkerThreadQueueTest : public ::testing::Test
+    {
+    };
+
+    TEST_F(WorkerThreadQueueTest, UnbudgetedDrainRunsEverything)
+    {
+        WorkerThreadQueue queue(ThreadContextType::Main);
+
+        int counter = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            queue.PushWork([&counter] { ++counter; });
+        }
+
+        EXPECT_EQ(queue.TryExecuteWork(), 100);
+        EXPECT_EQ(counter, 100);
+        EXPECT_FALSE(queue.HasWork());
+    }
+
+    TEST_F(WorkerThreadQueueTest, NestedDrainRunsFromInsideAnItem)
+    {
+        WorkerThreadQueue queue(ThreadContextType::Main);
+
+        // Like a main thread item blocking on work that needs another main thread item to finish first
+        int nested_ran = 0;
+        int counter = 0;
+        queue.PushWork([&]
+        {
+            queue.PushWork([&counter] { ++counter; });
+            nested_ran = queue.TryExecuteWork();
+            ++counter;
+        });
+
+        EXPECT_EQ(queue.TryExecuteWork(), 1);
+        EXPECT_EQ(nested_ran, 1);
+        EXPECT_EQ(counter, 2);
+        EXPECT_FALSE(queue.HasWork());
+    }
+
+    TEST_F(WorkerThreadQueueTest, ZeroBudgetRunsOneItem)
+    {
+        WorkerThreadQueue queue(ThreadContextType::Main);
+
+        int counter = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            queue.PushWork([&counter] { ++counter; });
+        }
+
+        EXPECT_EQ(queue.TryExecuteWork(std::chrono::nanoseconds(0)), 1);
+        EXPECT_EQ(counter, 1);
+        EXPECT_TRUE(queue.HasWork());
+    }
+
+    TEST_F(WorkerThreadQueueTest, BudgetLeavesTheRestForLater)
+    {
+        WorkerThreadQueue queue(ThreadContextType::Main);
+
+        constexpr int NumItems = 20;
+        int counter = 0;
+        for (int i = 0; i < NumItems; ++i)
+        {
+            queue.PushWork([&counter]
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++counter;
+            });
+        }
+
+        const int first_run = queue.TryExecuteWork(std::chrono::milliseconds(3));
+        EXPECT_GE(first_run, 1);
+        EXPECT_LT(first_run, NumItems);
+        EXPECT_EQ(counter, first_run);
+        EXPECT_TRUE(queue.HasWork());
+
+        // Leftovers are still in order and all run on later calls
+        int total_run = first_run;
+        while (queue.HasWork())
+        {
+            total_run += queue.TryExecuteWork(std::chrono::milliseconds(3));
+        }
+
+        EXPECT_EQ(total_run, NumItems);
+        EXPECT_EQ(counter, NumItems);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}